@@ -0,0 +1,319 @@
+#pragma once
+
+#include "pool_policies.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+
+// A thread pool assembled from compile-time policies. Workers share one queue guarded by one mutex;
+// there is no monitor thread and no virtual dispatch. With InplaceTask the bound callable and its
+// promise live in the queue entry when they fit its buffer, so the future's shared state is the only
+// allocation per task; larger tasks cost one more allocation.
+template<typename QueuePolicy, typename IdlePolicy, typename ScalingPolicy, typename TaskStorage>
+class BasicThreadPool
+{
+public:
+    enum Status : int32_t
+    {
+        Running,
+        Stop
+    };
+
+    explicit BasicThreadPool(size_t thread_num = std::max(1u, std::thread::hardware_concurrency()));
+
+    BasicThreadPool(size_t min_thread_num, size_t thread_num, size_t max_thread_num);
+
+    BasicThreadPool(const BasicThreadPool &) = delete;
+
+    BasicThreadPool &operator=(const BasicThreadPool &) = delete;
+
+    ~BasicThreadPool();
+
+    void start();
+
+    void stop();
+
+    template<typename Fn, typename... Args>
+    auto add_task(TaskPriority priority, Fn &&f, Args &&...args)
+            -> std::future<decltype(f(std::forward<Args>(args)...))>;
+
+    template<typename Fn, typename... Args>
+    auto add_task(Fn &&f, Args &&...args)
+            -> std::future<decltype(f(std::forward<Args>(args)...))>;
+
+    size_t get_thread_num() const;
+
+    Status get_status() const;
+
+    size_t get_task_num() const;
+
+private:
+    using Thread_iter = typename std::list<std::thread>::iterator;
+
+    void add_worker();
+
+    void run(Thread_iter self);
+
+    void join_retired();
+
+    Status status_ = Status::Stop;
+    mutable std::mutex mtx_;
+    std::condition_variable cond_;
+    typename QueuePolicy::template type<TaskStorage> task_queue_;
+    std::atomic<size_t> pending_num_{0};
+    size_t running_num_ = 0;
+    size_t sleeping_num_ = 0;
+    std::list<std::thread> threads_;
+    std::vector<std::thread> retired_;
+
+    size_t min_thread_num_ = 1;
+    size_t thread_num_ = 1;
+    size_t max_thread_num_ = 1;
+};
+
+// Presets
+
+// Fixed-size compute pool: FIFO, no priorities, no scaling, tasks stored inline up to 64 bytes
+// including their promise.
+using FixedThreadPool = BasicThreadPool<FifoQueuePolicy, BlockingIdle, FixedScaling, InplaceTask<64>>;
+
+// Fixed-size pool whose idle workers spin briefly before sleeping, for latency-sensitive bursts.
+using SpinningThreadPool = BasicThreadPool<FifoQueuePolicy, SpinIdle<>, FixedScaling, InplaceTask<64>>;
+
+// Priority-ordered pool that grows and shrinks between min_thread_num and max_thread_num.
+using DynamicPriorityThreadPool =
+        BasicThreadPool<PriorityQueuePolicy, BlockingIdle, DynamicScaling<>, std::function<void()>>;
+
+template<typename QueuePolicy, typename IdlePolicy, typename ScalingPolicy, typename TaskStorage>
+BasicThreadPool<QueuePolicy, IdlePolicy, ScalingPolicy, TaskStorage>::BasicThreadPool(size_t thread_num) :
+    BasicThreadPool(thread_num, thread_num, thread_num)
+{
+}
+
+template<typename QueuePolicy, typename IdlePolicy, typename ScalingPolicy, typename TaskStorage>
+BasicThreadPool<QueuePolicy, IdlePolicy, ScalingPolicy, TaskStorage>::BasicThreadPool(size_t min_thread_num,
+                                                                                      size_t thread_num,
+                                                                                      size_t max_thread_num) :
+    min_thread_num_(min_thread_num), thread_num_(thread_num), max_thread_num_(std::max(max_thread_num, thread_num))
+{
+}
+
+template<typename QueuePolicy, typename IdlePolicy, typename ScalingPolicy, typename TaskStorage>
+BasicThreadPool<QueuePolicy, IdlePolicy, ScalingPolicy, TaskStorage>::~BasicThreadPool()
+{
+    stop();
+}
+
+template<typename QueuePolicy, typename IdlePolicy, typename ScalingPolicy, typename TaskStorage>
+void BasicThreadPool<QueuePolicy, IdlePolicy, ScalingPolicy, TaskStorage>::start()
+{
+    std::lock_guard lock(mtx_);
+    if (status_ == Status::Running)
+        return;
+    status_ = Status::Running;
+    for (size_t i = 0; i < thread_num_; ++i)
+    {
+        add_worker();
+    }
+}
+
+template<typename QueuePolicy, typename IdlePolicy, typename ScalingPolicy, typename TaskStorage>
+void BasicThreadPool<QueuePolicy, IdlePolicy, ScalingPolicy, TaskStorage>::stop()
+{
+    std::list<std::thread> threads;
+    {
+        std::lock_guard lock(mtx_);
+        if (status_ == Status::Stop)
+            return;
+        status_ = Status::Stop;
+        task_queue_.clear();
+        pending_num_.store(0, std::memory_order_relaxed);
+        threads.swap(threads_);
+        join_retired();
+    }
+    cond_.notify_all();
+    for (auto &thread: threads)
+    {
+        if (thread.joinable())
+            thread.join();
+    }
+}
+
+template<typename QueuePolicy, typename IdlePolicy, typename ScalingPolicy, typename TaskStorage>
+template<typename Fn, typename... Args>
+auto BasicThreadPool<QueuePolicy, IdlePolicy, ScalingPolicy, TaskStorage>::add_task(TaskPriority priority, Fn &&f,
+                                                                                    Args &&...args)
+        -> std::future<decltype(f(std::forward<Args>(args)...))>
+{
+    using return_type = decltype(f(std::forward<Args>(args)...));
+    std::future<return_type> future;
+
+    TaskStorage storage = [&]()
+    {
+        if constexpr (std::is_copy_constructible_v<TaskStorage>)
+        {
+            auto task = std::make_shared<std::packaged_task<return_type()>>(
+                    std::bind(std::forward<Fn>(f), std::forward<Args>(args)...));
+            future = task->get_future();
+            return TaskStorage([task]() { (*task)(); });
+        }
+        else
+        {
+            std::promise<return_type> promise;
+            future = promise.get_future();
+            return TaskStorage([promise = std::move(promise),
+                                callable = std::bind(std::forward<Fn>(f), std::forward<Args>(args)...)]() mutable
+                               {
+                                   try
+                                   {
+                                       if constexpr (std::is_void_v<return_type>)
+                                       {
+                                           callable();
+                                           promise.set_value();
+                                       }
+                                       else
+                                       {
+                                           promise.set_value(callable());
+                                       }
+                                   }
+                                   catch (...)
+                                   {
+                                       promise.set_exception(std::current_exception());
+                                   }
+                               });
+        }
+    }();
+
+    bool notify = false;
+    {
+        std::lock_guard lock(mtx_);
+        if (status_ == Status::Stop)
+        {
+            throw std::runtime_error("BasicThreadPool::add_task() failed, The BasicThreadPool has been Stopped.");
+        }
+        task_queue_.push(std::move(storage), priority);
+        pending_num_.store(task_queue_.size(), std::memory_order_relaxed);
+        notify = sleeping_num_ > 0;
+
+        if constexpr (ScalingPolicy::dynamic)
+        {
+            if (!notify && threads_.size() < max_thread_num_ && task_queue_.size() > threads_.size() - running_num_)
+                add_worker();
+        }
+    }
+    if (notify)
+        cond_.notify_one();
+    return future;
+}
+
+template<typename QueuePolicy, typename IdlePolicy, typename ScalingPolicy, typename TaskStorage>
+template<typename Fn, typename... Args>
+auto BasicThreadPool<QueuePolicy, IdlePolicy, ScalingPolicy, TaskStorage>::add_task(Fn &&f, Args &&...args)
+        -> std::future<decltype(f(std::forward<Args>(args)...))>
+{
+    return add_task(TaskPriority::Normal, std::forward<Fn>(f), std::forward<Args>(args)...);
+}
+
+template<typename QueuePolicy, typename IdlePolicy, typename ScalingPolicy, typename TaskStorage>
+size_t BasicThreadPool<QueuePolicy, IdlePolicy, ScalingPolicy, TaskStorage>::get_thread_num() const
+{
+    std::lock_guard lock(mtx_);
+    return threads_.size();
+}
+
+template<typename QueuePolicy, typename IdlePolicy, typename ScalingPolicy, typename TaskStorage>
+typename BasicThreadPool<QueuePolicy, IdlePolicy, ScalingPolicy, TaskStorage>::Status
+BasicThreadPool<QueuePolicy, IdlePolicy, ScalingPolicy, TaskStorage>::get_status() const
+{
+    std::lock_guard lock(mtx_);
+    return status_;
+}
+
+template<typename QueuePolicy, typename IdlePolicy, typename ScalingPolicy, typename TaskStorage>
+size_t BasicThreadPool<QueuePolicy, IdlePolicy, ScalingPolicy, TaskStorage>::get_task_num() const
+{
+    std::lock_guard lock(mtx_);
+    return task_queue_.size() + running_num_;
+}
+
+template<typename QueuePolicy, typename IdlePolicy, typename ScalingPolicy, typename TaskStorage>
+void BasicThreadPool<QueuePolicy, IdlePolicy, ScalingPolicy, TaskStorage>::add_worker()
+{
+    join_retired();
+    // The worker takes the lock before touching its iterator, so it only starts once it is assigned.
+    auto self = threads_.emplace(threads_.end());
+    *self = std::thread([this, self]() { run(self); });
+}
+
+template<typename QueuePolicy, typename IdlePolicy, typename ScalingPolicy, typename TaskStorage>
+void BasicThreadPool<QueuePolicy, IdlePolicy, ScalingPolicy, TaskStorage>::join_retired()
+{
+    // Retired workers hand themselves over with the lock held and return right after releasing it.
+    for (auto &thread: retired_)
+    {
+        if (thread.joinable())
+            thread.join();
+    }
+    retired_.clear();
+}
+
+template<typename QueuePolicy, typename IdlePolicy, typename ScalingPolicy, typename TaskStorage>
+void BasicThreadPool<QueuePolicy, IdlePolicy, ScalingPolicy, TaskStorage>::run(Thread_iter self)
+{
+    std::unique_lock lock(mtx_);
+    while (true)
+    {
+        if constexpr (IdlePolicy::spin_num > 0)
+        {
+            if (status_ == Status::Running && task_queue_.empty())
+            {
+                lock.unlock();
+                for (size_t i = 0; i < IdlePolicy::spin_num && pending_num_.load(std::memory_order_relaxed) == 0; ++i)
+                {
+                    std::this_thread::yield();
+                }
+                lock.lock();
+            }
+        }
+
+        auto ready = [this]() { return status_ == Status::Stop || !task_queue_.empty(); };
+        ++sleeping_num_;
+        if constexpr (ScalingPolicy::dynamic)
+        {
+            if (!cond_.wait_for(lock, ScalingPolicy::idle_timeout, ready) && threads_.size() > min_thread_num_)
+            {
+                --sleeping_num_;
+                retired_.emplace_back(std::move(*self));
+                threads_.erase(self);
+                return;
+            }
+        }
+        else
+        {
+            cond_.wait(lock, ready);
+        }
+        --sleeping_num_;
+
+        if (status_ == Status::Stop)
+            return;
+
+        TaskStorage task = task_queue_.pop();
+        pending_num_.store(task_queue_.size(), std::memory_order_relaxed);
+        ++running_num_;
+        lock.unlock();
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+        }
+        lock.lock();
+        --running_num_;
+    }
+}
@@ -9,7 +9,9 @@ public:
 
   ~DefaultStrategy() override = default;
 
-  void dispatch_task(std::vector<std::shared_ptr<Worker>> workers,const Task &task) override;
+  using ThreadPoolStrategy::dispatch_task;
+
+  void dispatch_task(const std::vector<std::shared_ptr<Worker>>& workers,Task &&task) override;
 
   void adjust_worker(size_t min_thread_num, size_t max_thread_num,size_t new_task_num,std::vector<std::shared_ptr<Worker>>& workers) override;
 };
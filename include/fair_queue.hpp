@@ -0,0 +1,240 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <shared_mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "scheduling_class.h"
+
+// Lets FairQueue run unsynchronised when its owner already guards it with a lock of its own.
+struct NullMutex
+{
+    void lock() {}
+
+    void unlock() {}
+
+    void lock_shared() {}
+
+    void unlock_shared() {}
+};
+
+// A priority queue split into one lane per scheduling class. Lanes of the highest class priority present
+// are served by deficit round robin with the class weight as quantum, tasks inside a lane by priority
+// and then in insertion order.
+// T must provide operator< and scheduling_class() returning a smart pointer (null = default class).
+template <typename T, typename Mutex = std::shared_mutex>
+class FairQueue
+{
+public:
+    FairQueue() = default;
+
+    ~FairQueue() = default;
+
+    FairQueue(const FairQueue& other)
+    {
+        std::shared_lock lock(other.mtx_);
+        copy_state(other);
+    }
+
+    FairQueue& operator=(const FairQueue& other)
+    {
+        if (this != &other)
+        {
+            std::unique_lock lock_m(mtx_);
+            std::shared_lock lock(other.mtx_);
+            copy_state(other);
+        }
+        return *this;
+    }
+
+    FairQueue(FairQueue&& other) noexcept
+    {
+        std::unique_lock lock_m(mtx_);
+        move_state(std::move(other));
+    }
+
+    FairQueue& operator=(FairQueue&& other) noexcept
+    {
+        if (this != &other)
+        {
+            std::unique_lock lock_m(mtx_);
+            move_state(std::move(other));
+        }
+        return *this;
+    }
+
+    void push(T val)
+    {
+        std::unique_lock lock(mtx_);
+        const SchedulingClass *key = val.scheduling_class().get();
+        Lane *lane = nullptr;
+        for (auto &candidate: lanes_)
+        {
+            if (candidate.key_ == key)
+            {
+                lane = &candidate;
+                break;
+            }
+        }
+        if (lane == nullptr)
+        {
+            lane = &lanes_.emplace_back();
+            lane->key_ = key;
+        }
+        lane->heap_.push_back(Entry{std::move(val), seq_++});
+        std::push_heap(lane->heap_.begin(), lane->heap_.end());
+        ++size_;
+    }
+
+    T pop()
+    {
+        std::unique_lock lock(mtx_);
+        if (size_ == 0)
+            throw std::out_of_range("FairQueue::pop");
+        return pop_locked();
+    }
+
+    bool try_pop(T& val)
+    {
+        std::unique_lock lock(mtx_);
+        if (size_ == 0)
+            return false;
+        val = pop_locked();
+        return true;
+    }
+
+    size_t size() const
+    {
+        std::shared_lock lock(mtx_);
+        return size_;
+    }
+
+    void clear()
+    {
+        std::unique_lock lock(mtx_);
+        lanes_.clear();
+        cursor_ = 0;
+        size_ = 0;
+    }
+
+    bool empty() const
+    {
+        std::shared_lock lock(mtx_);
+        return size_ == 0;
+    }
+
+private:
+    struct Entry
+    {
+        T value_;
+        uint64_t seq_;
+
+        bool operator<(const Entry& other) const
+        {
+            if (value_ < other.value_)
+                return true;
+            if (other.value_ < value_)
+                return false;
+            return seq_ > other.seq_;
+        }
+    };
+
+    struct Lane
+    {
+        const SchedulingClass *key_ = nullptr;
+        uint64_t deficit_ = 0;
+        // A max-heap kept with push_heap/pop_heap, so the served entry can be moved out of back().
+        std::vector<Entry> heap_;
+    };
+
+    static uint64_t weight_of(const Lane& lane)
+    {
+        return lane.key_ == nullptr ? 1 : lane.key_->get_weight();
+    }
+
+    static TaskPriority priority_of(const Lane& lane)
+    {
+        return lane.key_ == nullptr ? TaskPriority::Normal : lane.key_->get_priority();
+    }
+
+    TaskPriority top_priority() const
+    {
+        TaskPriority top = TaskPriority::Lowest;
+        for (const auto &lane: lanes_)
+        {
+            top = std::max(top, priority_of(lane));
+        }
+        return top;
+    }
+
+    T pop_locked()
+    {
+        size_t index = select();
+        Lane &lane = lanes_[index];
+        std::pop_heap(lane.heap_.begin(), lane.heap_.end());
+        T val = std::move(lane.heap_.back().value_);
+        lane.heap_.pop_back();
+        --size_;
+        if (lane.deficit_ > 0)
+            --lane.deficit_;
+        if (lane.heap_.empty())
+        {
+            lanes_.erase(lanes_.begin() + static_cast<std::ptrdiff_t>(index));
+            if (index < cursor_)
+            {
+                --cursor_;
+            }
+            else if (index == cursor_ && !lanes_.empty())
+            {
+                // The lane after the removed one now sits under the cursor and receives its quantum.
+                cursor_ %= lanes_.size();
+                if (priority_of(lanes_[cursor_]) == top_priority())
+                    lanes_[cursor_].deficit_ += weight_of(lanes_[cursor_]);
+            }
+        }
+        return val;
+    }
+
+    // Index of the lane to serve next; advances the round robin while the current lane has no deficit left.
+    // Lanes below the top priority are passed over and keep their deficit until they are on top.
+    size_t select()
+    {
+        if (lanes_.size() == 1)
+            return 0;
+        TaskPriority top = top_priority();
+        while (priority_of(lanes_[cursor_]) != top || lanes_[cursor_].deficit_ == 0)
+        {
+            cursor_ = (cursor_ + 1) % lanes_.size();
+            if (priority_of(lanes_[cursor_]) == top)
+                lanes_[cursor_].deficit_ += weight_of(lanes_[cursor_]);
+        }
+        return cursor_;
+    }
+
+    void copy_state(const FairQueue& other)
+    {
+        lanes_ = other.lanes_;
+        cursor_ = other.cursor_;
+        size_ = other.size_;
+        seq_ = other.seq_;
+    }
+
+    void move_state(FairQueue&& other)
+    {
+        lanes_ = std::move(other.lanes_);
+        cursor_ = other.cursor_;
+        size_ = other.size_;
+        seq_ = other.seq_;
+        other.lanes_.clear();
+        other.size_ = 0;
+    }
+
+    mutable Mutex mtx_;
+
+    std::vector<Lane> lanes_;
+    size_t cursor_ = 0;
+    size_t size_ = 0;
+    uint64_t seq_ = 0;
+};
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "thread_pool_types.h"
+
+// Compile-time building blocks for BasicThreadPool. Queue policies are not synchronised themselves;
+// the pool guards them with its single mutex.
+
+// Queue policies
+
+struct FifoQueuePolicy
+{
+    template<typename T>
+    class type
+    {
+    public:
+        void push(T &&val, TaskPriority) { queue_.push_back(std::move(val)); }
+
+        T pop()
+        {
+            T val = std::move(queue_.front());
+            queue_.pop_front();
+            return val;
+        }
+
+        size_t size() const { return queue_.size(); }
+
+        bool empty() const { return queue_.empty(); }
+
+        void clear() { queue_.clear(); }
+
+    private:
+        std::deque<T> queue_;
+    };
+};
+
+struct PriorityQueuePolicy
+{
+    // Highest priority first, insertion order among equal priorities.
+    template<typename T>
+    class type
+    {
+    public:
+        void push(T &&val, TaskPriority priority)
+        {
+            heap_.push_back(Entry{priority, seq_++, std::move(val)});
+            std::push_heap(heap_.begin(), heap_.end());
+        }
+
+        T pop()
+        {
+            std::pop_heap(heap_.begin(), heap_.end());
+            T val = std::move(heap_.back().value_);
+            heap_.pop_back();
+            return val;
+        }
+
+        size_t size() const { return heap_.size(); }
+
+        bool empty() const { return heap_.empty(); }
+
+        void clear() { heap_.clear(); }
+
+    private:
+        struct Entry
+        {
+            TaskPriority priority_;
+            uint64_t seq_;
+            T value_;
+
+            bool operator<(const Entry &other) const
+            {
+                if (priority_ != other.priority_)
+                    return priority_ < other.priority_;
+                return seq_ > other.seq_;
+            }
+        };
+
+        std::vector<Entry> heap_;
+        uint64_t seq_ = 0;
+    };
+};
+
+// Idle policies: what a worker does with an empty queue before it blocks on the condition variable.
+
+struct BlockingIdle
+{
+    static constexpr size_t spin_num = 0;
+};
+
+template<size_t SpinNum = 4096>
+struct SpinIdle
+{
+    static constexpr size_t spin_num = SpinNum;
+};
+
+// Scaling policies
+
+// Starts thread_num workers and never changes the count; no bookkeeping on the submit path.
+struct FixedScaling
+{
+    static constexpr bool dynamic = false;
+};
+
+// Adds a worker on submit while the backlog exceeds the worker count and nobody is idle, and retires
+// workers that stayed idle for IdleTimeoutMs, never going below min_thread_num.
+template<size_t IdleTimeoutMs = 1000>
+struct DynamicScaling
+{
+    static constexpr bool dynamic = true;
+
+    static constexpr std::chrono::milliseconds idle_timeout{IdleTimeoutMs};
+};
+
+// Task storage: a move-only callable kept inline in a fixed buffer, so queueing it does not allocate.
+// Callables larger than Capacity, over-aligned, or not nothrow-movable are kept on the heap instead.
+template<size_t Capacity>
+class InplaceTask
+{
+    static_assert(Capacity >= sizeof(void *), "InplaceTask: the buffer must at least hold a pointer");
+
+public:
+    InplaceTask() = default;
+
+    template<typename Fn, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Fn>, InplaceTask>>>
+    InplaceTask(Fn &&fn)
+    {
+        using F = std::decay_t<Fn>;
+        if constexpr (fits_inline<F>)
+        {
+            ::new (static_cast<void *>(storage_)) F(std::forward<Fn>(fn));
+            ops_ = &inline_ops<F>;
+        }
+        else
+        {
+            ::new (static_cast<void *>(storage_)) F *(new F(std::forward<Fn>(fn)));
+            ops_ = &heap_ops<F>;
+        }
+    }
+
+    InplaceTask(const InplaceTask &) = delete;
+
+    InplaceTask &operator=(const InplaceTask &) = delete;
+
+    InplaceTask(InplaceTask &&other) noexcept
+    {
+        if (other.ops_ != nullptr)
+        {
+            other.ops_->move(storage_, other.storage_);
+            ops_ = std::exchange(other.ops_, nullptr);
+        }
+    }
+
+    InplaceTask &operator=(InplaceTask &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            if (other.ops_ != nullptr)
+            {
+                other.ops_->move(storage_, other.storage_);
+                ops_ = std::exchange(other.ops_, nullptr);
+            }
+        }
+        return *this;
+    }
+
+    ~InplaceTask() { reset(); }
+
+    void operator()() { ops_->invoke(storage_); }
+
+    explicit operator bool() const { return ops_ != nullptr; }
+
+private:
+    struct Ops
+    {
+        void (*invoke)(void *);
+        void (*move)(void *, void *);
+        void (*destroy)(void *);
+    };
+
+    template<typename F>
+    static constexpr bool fits_inline = sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t) &&
+                                        std::is_nothrow_move_constructible_v<F>;
+
+    template<typename F>
+    static constexpr Ops inline_ops = {
+            [](void *p) { (*static_cast<F *>(p))(); },
+            [](void *dst, void *src)
+            {
+                ::new (dst) F(std::move(*static_cast<F *>(src)));
+                static_cast<F *>(src)->~F();
+            },
+            [](void *p) { static_cast<F *>(p)->~F(); }};
+
+    // The buffer holds only an owning pointer; moving the task moves the pointer.
+    template<typename F>
+    static constexpr Ops heap_ops = {
+            [](void *p) { (**static_cast<F **>(p))(); },
+            [](void *dst, void *src) { ::new (dst) F *(*static_cast<F **>(src)); },
+            [](void *p) { delete *static_cast<F **>(p); }};
+
+    void reset()
+    {
+        if (ops_ != nullptr)
+        {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[Capacity];
+    const Ops *ops_ = nullptr;
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "default_strategy.h"
+
+// Places every task on the less loaded of two randomly sampled workers, reading their lock-free
+// pending counters, so dispatch costs O(1) instead of a locked scan over all workers.
+// Worker scaling is inherited from DefaultStrategy.
+class PowerOfTwoStrategy : public DefaultStrategy
+{
+public:
+    PowerOfTwoStrategy() = default;
+
+    ~PowerOfTwoStrategy() override = default;
+
+    using DefaultStrategy::dispatch_task;
+
+    void dispatch_task(const std::vector<std::shared_ptr<Worker>>& workers,Task &&task) override;
+
+private:
+    static size_t next_index(size_t bound);
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include "thread_pool_types.h"
+
+// A named share of the pool. Classes with tasks queued are served in proportion to their weights,
+// and every class accounts the worker time its tasks consumed. A class priority above the others'
+// is served strictly first; weights only share among classes of the same priority.
+class SchedulingClass
+{
+public:
+    SchedulingClass(std::string name, uint32_t weight, TaskPriority priority = TaskPriority::Normal);
+
+    SchedulingClass(const SchedulingClass &) = delete;
+
+    SchedulingClass &operator=(const SchedulingClass &) = delete;
+
+    ~SchedulingClass() = default;
+
+    const std::string &get_name() const;
+
+    uint32_t get_weight() const;
+
+    void set_weight(uint32_t weight);
+
+    TaskPriority get_priority() const;
+
+    std::chrono::nanoseconds get_consumed_time() const;
+
+    size_t get_completed_task_num() const;
+
+    void charge(std::chrono::nanoseconds elapsed);
+
+private:
+    const std::string name_;
+    std::atomic<uint32_t> weight_;
+    const TaskPriority priority_;
+    std::atomic<int64_t> consumed_ns_{0};
+    std::atomic<size_t> completed_task_num_{0};
+};
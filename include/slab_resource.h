@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+// A memory_resource that serves small blocks from per-thread slab caches. A block released on another
+// thread is pushed back to the cache that allocated it through a lock-free list, so no thread ever
+// frees into a foreign arena. Requests larger than max_block_size or over-aligned go to the upstream.
+class SlabResource : public std::pmr::memory_resource
+{
+public:
+    static constexpr size_t max_block_size = 512;
+
+    static constexpr size_t slab_size = 64 * 1024;
+
+    explicit SlabResource(std::pmr::memory_resource *upstream = std::pmr::new_delete_resource());
+
+    SlabResource(const SlabResource &) = delete;
+
+    SlabResource &operator=(const SlabResource &) = delete;
+
+    ~SlabResource() override;
+
+    std::pmr::memory_resource *upstream() const;
+
+    static SlabResource *global();
+
+private:
+    struct Header;
+
+    struct Cache;
+
+    struct ThreadCaches;
+
+    void *do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+    Cache *local_cache(bool create);
+
+    Header *carve(Cache *cache, size_t size_class);
+
+    std::pmr::memory_resource *upstream_;
+    const uint64_t id_;
+    std::mutex mtx_;
+    std::vector<std::shared_ptr<Cache>> caches_;
+};
@@ -1,15 +1,19 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 
+#include "scheduling_class.h"
 #include "thread_pool_types.h"
+#include "trace.h"
 
 class Task
 {
 public:
     Task() = default;
 
-    explicit Task(std::function<void()>,TaskPriority = TaskPriority::Normal);
+    explicit Task(std::function<void()>,TaskPriority = TaskPriority::Normal,
+                  std::shared_ptr<SchedulingClass> = nullptr);
 
     Task(const Task&);
 
@@ -31,8 +35,20 @@ public:
 
     void operator()() const noexcept;
 
+    const std::shared_ptr<SchedulingClass>& scheduling_class() const;
+
+#ifdef THREAD_POOL_ENABLE_TRACE
+    uint64_t trace_id() const;
+#endif
+
 private:
     std::function<void()> task_;
 
     TaskPriority priority_ = TaskPriority::Normal;
+
+    std::shared_ptr<SchedulingClass> scheduling_class_;
+
+#ifdef THREAD_POOL_ENABLE_TRACE
+    uint64_t trace_id_ = 0;
+#endif
 };
\ No newline at end of file
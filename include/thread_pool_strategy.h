@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <memory>
+#include <stdexcept>
 #include "worker.h"
 
 class ThreadPoolStrategy
@@ -9,7 +10,18 @@ class ThreadPoolStrategy
 public:
     virtual ~ThreadPoolStrategy() = default;
 
-    virtual void dispatch_task(std::vector<std::shared_ptr<Worker>> workers,const Task &task) = 0;
+    // Places one task on a worker. The default forwards to the by-value overload below, so strategies
+    // written against that signature keep working; new strategies should override this one.
+    virtual void dispatch_task(const std::vector<std::shared_ptr<Worker>>& workers,Task &&task)
+    {
+        dispatch_task(std::vector<std::shared_ptr<Worker>>(workers), static_cast<const Task &>(task));
+    }
+
+    // The original signature, which copies the worker list for every task.
+    virtual void dispatch_task(std::vector<std::shared_ptr<Worker>>,const Task &)
+    {
+        throw std::logic_error("ThreadPoolStrategy::dispatch_task() is not implemented");
+    }
 
     virtual void adjust_worker(size_t min_thread_num, size_t max_thread_num,size_t new_task_num,std::vector<std::shared_ptr<Worker>>& workers) = 0;
 };
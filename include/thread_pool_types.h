@@ -1,7 +1,11 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
+// Fields written by different threads are padded apart by this much to avoid false sharing.
+inline constexpr size_t cache_line_size = 64;
+
 enum TaskPriority : int32_t
 {
     Lowest = 0,
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+enum class TraceEvent : uint8_t
+{
+    Submit = 0,
+    Dispatch = 1,
+    Start = 2,
+    End = 3,
+    WorkerSpawn = 4,
+    WorkerStop = 5
+};
+
+// Records thread pool events into per-thread ring buffers and dumps them as Chrome trace JSON, which
+// chrome://tracing and the Perfetto UI both load. Recording is compiled in only with
+// THREAD_POOL_ENABLE_TRACE and additionally has to be switched on with enable(). dump_chrome_trace() and
+// clear() may run while other threads record; slots overwritten during a dump are skipped.
+class Tracer
+{
+public:
+    static constexpr size_t ring_capacity = 1 << 16;
+
+    static void enable();
+
+    static void disable();
+
+    static bool is_enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    static uint64_t next_id();
+
+    static void record(TraceEvent event, uint64_t id);
+
+    static void clear();
+
+    static bool dump_chrome_trace(const std::string &path);
+
+private:
+    static inline std::atomic<bool> enabled_{false};
+};
+
+#ifdef THREAD_POOL_ENABLE_TRACE
+#define THREAD_POOL_TRACE(event, id)         \
+    do                                       \
+    {                                        \
+        if (Tracer::is_enabled())            \
+            Tracer::record((event), (id));   \
+    } while (0)
+#else
+#define THREAD_POOL_TRACE(event, id) \
+    do                               \
+    {                                \
+    } while (0)
+#endif
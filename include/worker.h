@@ -1,9 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
 #include <thread>
 #include <condition_variable>
 
-#include "priority_queue.hpp"
+#include "fair_queue.hpp"
 
 #include "task.h"
 
@@ -36,18 +38,35 @@ public:
 
     void add_task(const Task&);
 
+    void add_task(Task&&);
+
     void notify() ;
 
     bool is_busy() const;
 
     size_t pending_task_size() const;
 
+    // Lets the worker pull its next task from a shared queue whenever its own queue runs dry.
+    void set_task_source(std::function<bool(Task &)> source);
+
+    bool has_task_source() const;
+
 private:
     void run();
 
-    mutable std::shared_mutex mtx_;
-    PriorityQueue<Task> task_queue_;
-    std::condition_variable_any cond_;
-    std::unique_ptr<std::thread> thread_ptr_;
+    bool pull_task();
+
+    // The queue and everything the worker waits on share one mutex; the queue has no lock of its own.
+    alignas(cache_line_size) mutable std::mutex mtx_;
+    FairQueue<Task, NullMutex> task_queue_;
+    std::condition_variable cond_;
     WorkerStatus status_ = WorkerStatus::Busy;
+    std::function<bool(Task &)> task_source_;
+
+    // Pending = submitted - completed. Each counter has a single writer side and its own cache line,
+    // so dispatchers read the load without locking and submitters and the worker never share a line.
+    alignas(cache_line_size) std::atomic<size_t> submitted_num_{0};
+    alignas(cache_line_size) std::atomic<size_t> completed_num_{0};
+
+    alignas(cache_line_size) std::unique_ptr<std::thread> thread_ptr_;
 };
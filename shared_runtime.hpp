@@ -0,0 +1,299 @@
+#pragma once
+
+#include "thread_pool.hpp"
+
+class SharedRuntime;
+
+// A logical pool backed by the threads of a SharedRuntime. It keeps its own queue, concurrency cap,
+// priority and statistics, and never occupies more than max_concurrency runtime threads at once.
+class Executor : public std::enable_shared_from_this<Executor>
+{
+public:
+    Executor(const Executor &) = delete;
+
+    Executor &operator=(const Executor &) = delete;
+
+    ~Executor() = default;
+
+    template<typename Fn, typename... Args>
+    auto add_task(TaskPriority priority, Fn &&f, Args &&...args)
+            -> std::future<decltype(f(std::forward<Args>(args)...))>;
+
+    template<typename Fn, typename... Args>
+    auto add_task(Fn &&f, Args &&...args)
+            -> std::future<decltype(f(std::forward<Args>(args)...))>;
+
+    const std::string &get_name() const;
+
+    size_t get_max_concurrency() const;
+
+    TaskPriority get_priority() const;
+
+    size_t get_task_num() const;
+
+    size_t get_running_num() const;
+
+    size_t get_completed_task_num() const;
+
+    std::chrono::nanoseconds get_consumed_time() const;
+
+private:
+    friend class SharedRuntime;
+
+    // One drain submitted to the runtime, holding one concurrency slot. If the runtime drops or rejects it
+    // without running (stop() clears the queues), its destructor gives the slot back.
+    struct Drain
+    {
+        explicit Drain(std::shared_ptr<Executor> executor);
+
+        Drain(Drain &&) noexcept = default;
+
+        ~Drain();
+
+        void operator()();
+
+        std::shared_ptr<Executor> executor_;
+    };
+
+    Executor(ThreadPool &pool, std::shared_ptr<SchedulingClass> scheduling_class, size_t max_concurrency,
+             size_t batch_size);
+
+    void schedule();
+
+    void drain();
+
+    void release_slot();
+
+    ThreadPool &pool_;
+    const std::shared_ptr<SchedulingClass> scheduling_class_;
+    const size_t max_concurrency_;
+    const size_t batch_size_;
+
+    mutable std::mutex mtx_;
+    FairQueue<Task, NullMutex> task_queue_;
+    size_t scheduled_num_ = 0;
+    size_t running_num_ = 0;
+    size_t completed_task_num_ = 0;
+};
+
+// Owns one fixed set of worker threads, sized to the machine, and hands out Executors that share it.
+// The runtime must outlive every Executor it created. Executor names are unique among live executors.
+class SharedRuntime
+{
+public:
+    explicit SharedRuntime(size_t thread_num = std::max(1u, std::thread::hardware_concurrency()),
+                           const std::shared_ptr<ThreadPoolStrategy> &strategy = std::make_shared<DefaultStrategy>());
+
+    SharedRuntime(const SharedRuntime &) = delete;
+
+    SharedRuntime &operator=(const SharedRuntime &) = delete;
+
+    ~SharedRuntime();
+
+    std::shared_ptr<Executor> create_executor(const std::string &name, size_t max_concurrency, uint32_t weight = 1,
+                                              TaskPriority priority = TaskPriority::Normal, size_t batch_size = 16);
+
+    std::vector<std::shared_ptr<Executor>> get_executors() const;
+
+    size_t get_thread_num() const;
+
+private:
+    ThreadPool pool_;
+    mutable std::mutex mtx_;
+    std::vector<std::weak_ptr<Executor>> executors_;
+};
+
+inline Executor::Executor(ThreadPool &pool, std::shared_ptr<SchedulingClass> scheduling_class,
+                          size_t max_concurrency, size_t batch_size) :
+    pool_(pool), scheduling_class_(std::move(scheduling_class)), max_concurrency_(std::max<size_t>(max_concurrency, 1)),
+    batch_size_(std::max<size_t>(batch_size, 1))
+{
+}
+
+inline const std::string &Executor::get_name() const
+{
+    return scheduling_class_->get_name();
+}
+
+inline size_t Executor::get_max_concurrency() const
+{
+    return max_concurrency_;
+}
+
+inline TaskPriority Executor::get_priority() const
+{
+    return scheduling_class_->get_priority();
+}
+
+inline size_t Executor::get_task_num() const
+{
+    std::lock_guard lock(mtx_);
+    return task_queue_.size();
+}
+
+inline size_t Executor::get_running_num() const
+{
+    std::lock_guard lock(mtx_);
+    return running_num_;
+}
+
+inline size_t Executor::get_completed_task_num() const
+{
+    std::lock_guard lock(mtx_);
+    return completed_task_num_;
+}
+
+inline std::chrono::nanoseconds Executor::get_consumed_time() const
+{
+    return scheduling_class_->get_consumed_time();
+}
+
+template<typename Fn, typename... Args>
+auto Executor::add_task(TaskPriority priority, Fn &&f, Args &&...args)
+        -> std::future<decltype(f(std::forward<Args>(args)...))>
+{
+    using return_type = decltype(f(std::forward<Args>(args)...));
+    auto task = std::make_shared<std::packaged_task<return_type()>>(
+            std::bind(std::forward<Fn>(f), std::forward<Args>(args)...));
+    auto future = task->get_future();
+
+    if (pool_.get_status() == ThreadPool::Status::Stop)
+    {
+        throw std::runtime_error("Executor::add_task() failed, The SharedRuntime has been Stopped.");
+    }
+
+    {
+        std::lock_guard lock(mtx_);
+        task_queue_.push(Task([task]() { (*task)(); }, priority));
+    }
+    // If the runtime stopped since the check above, the rejected drain fails the backlog, this task
+    // included, once no other drain is left to serve it.
+    schedule();
+    return future;
+}
+
+template<typename Fn, typename... Args>
+auto Executor::add_task(Fn &&f, Args &&...args)
+        -> std::future<decltype(f(std::forward<Args>(args)...))>
+{
+    return add_task(TaskPriority::Normal, std::forward<Fn>(f), std::forward<Args>(args)...);
+}
+
+inline void Executor::schedule()
+{
+    // Each drain on the runtime holds one concurrency slot; only idle drains can pick up queued tasks.
+    // Slots are reserved under mtx_ but submitted without it, since a dropped drain takes mtx_ from
+    // inside the runtime.
+    while (true)
+    {
+        {
+            std::lock_guard lock(mtx_);
+            if (scheduled_num_ >= max_concurrency_ || scheduled_num_ - running_num_ >= task_queue_.size())
+                return;
+            ++scheduled_num_;
+        }
+        pool_.add_task(scheduling_class_, scheduling_class_->get_priority(), Drain(shared_from_this()));
+    }
+}
+
+inline void Executor::drain()
+{
+    {
+        std::unique_lock lock(mtx_);
+        for (size_t i = 0; i < batch_size_ && !task_queue_.empty(); ++i)
+        {
+            Task task = task_queue_.pop();
+            ++running_num_;
+            lock.unlock();
+            task();
+            lock.lock();
+            --running_num_;
+            ++completed_task_num_;
+        }
+        // Release the slot and let schedule() decide whether the backlog needs it again, so a long
+        // backlog yields the runtime thread between batches.
+        --scheduled_num_;
+    }
+    schedule();
+}
+
+inline void Executor::release_slot()
+{
+    FairQueue<Task, NullMutex> dropped;
+    std::lock_guard lock(mtx_);
+    --scheduled_num_;
+    // With no drain left nothing serves the backlog any more, so fail its tasks instead of stranding them.
+    if (scheduled_num_ == 0)
+        dropped = std::move(task_queue_);
+}
+
+inline Executor::Drain::Drain(std::shared_ptr<Executor> executor) : executor_(std::move(executor))
+{
+}
+
+inline Executor::Drain::~Drain()
+{
+    if (executor_ != nullptr)
+        executor_->release_slot();
+}
+
+inline void Executor::Drain::operator()()
+{
+    // Once running, the drain releases its slot itself.
+    auto executor = std::move(executor_);
+    executor->drain();
+}
+
+inline SharedRuntime::SharedRuntime(size_t thread_num, const std::shared_ptr<ThreadPoolStrategy> &strategy) :
+    pool_(thread_num, thread_num, thread_num, strategy)
+{
+    pool_.start();
+}
+
+inline SharedRuntime::~SharedRuntime()
+{
+    pool_.stop();
+}
+
+inline std::shared_ptr<Executor> SharedRuntime::create_executor(const std::string &name, size_t max_concurrency,
+                                                                uint32_t weight, TaskPriority priority,
+                                                                size_t batch_size)
+{
+    std::lock_guard lock(mtx_);
+    executors_.erase(std::remove_if(executors_.begin(), executors_.end(),
+                                    [](const std::weak_ptr<Executor> &executor) { return executor.expired(); }),
+                     executors_.end());
+    for (const auto &weak_executor: executors_)
+    {
+        auto executor = weak_executor.lock();
+        if (executor != nullptr && executor->get_name() == name)
+        {
+            throw std::runtime_error("SharedRuntime::create_executor() failed, The executor " + name +
+                                     " already exists.");
+        }
+    }
+
+    // Each executor owns its scheduling class, so its statistics are its own and go away with it. The
+    // class carries the executor priority, which the runtime queues serve before weights.
+    std::shared_ptr<Executor> executor(new Executor(pool_, std::make_shared<SchedulingClass>(name, weight, priority),
+                                                    max_concurrency, batch_size));
+    executors_.push_back(executor);
+    return executor;
+}
+
+inline std::vector<std::shared_ptr<Executor>> SharedRuntime::get_executors() const
+{
+    std::lock_guard lock(mtx_);
+    std::vector<std::shared_ptr<Executor>> executors;
+    for (const auto &weak_executor: executors_)
+    {
+        if (auto executor = weak_executor.lock())
+            executors.push_back(std::move(executor));
+    }
+    return executors;
+}
+
+inline size_t SharedRuntime::get_thread_num() const
+{
+    return pool_.get_thread_num();
+}
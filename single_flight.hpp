@@ -0,0 +1,242 @@
+#pragma once
+
+#include "thread_pool.hpp"
+
+#include <list>
+#include <unordered_map>
+
+// Deduplicates keyed submissions: while a task for a key is queued or running, add_task_once() with the
+// same key returns the shared future of that task instead of submitting another one. With a cache
+// capacity, successful results stay available for ttl (zero = until evicted) in LRU order.
+template<typename Key, typename Result, typename Hash = std::hash<Key>>
+class SingleFlight
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit SingleFlight(ThreadPool &pool, size_t cache_capacity = 0, Clock::duration ttl = Clock::duration::zero());
+
+    SingleFlight(const SingleFlight &) = delete;
+
+    SingleFlight &operator=(const SingleFlight &) = delete;
+
+    ~SingleFlight() = default;
+
+    template<typename Fn, typename... Args>
+    std::shared_future<Result> add_task_once(const Key &key, TaskPriority priority, Fn &&f, Args &&...args);
+
+    template<typename Fn, typename... Args>
+    std::shared_future<Result> add_task_once(const Key &key, Fn &&f, Args &&...args);
+
+    void forget(const Key &key);
+
+    size_t get_inflight_num() const;
+
+    size_t get_cached_num() const;
+
+private:
+    struct Entry
+    {
+        std::shared_future<Result> future_;
+        uint64_t generation_ = 0;
+        bool done_ = false;
+        Clock::time_point expire_at_;
+        typename std::list<Key>::iterator lru_;
+    };
+
+    struct State;
+
+    // One submitted task. If it is dropped without running (e.g. the pool stopped), its destructor still
+    // retires the entry so later callers do not wait on a broken future forever.
+    struct Flight
+    {
+        Flight(std::shared_ptr<State> state, Key key, uint64_t generation);
+
+        ~Flight();
+
+        template<typename Callable>
+        void run(Callable &callable);
+
+        std::shared_ptr<State> state_;
+        const Key key_;
+        const uint64_t generation_;
+        std::promise<Result> promise_;
+        bool finished_ = false;
+    };
+
+    // Shared with the submitted tasks so completion can be recorded after the group is gone.
+    struct State
+    {
+        void complete(const Key &key, uint64_t generation, bool succeeded);
+
+        void erase(typename std::unordered_map<Key, Entry, Hash>::iterator it);
+
+        mutable std::mutex mtx_;
+        std::unordered_map<Key, Entry, Hash> entries_;
+        std::list<Key> lru_;
+        size_t cache_capacity_ = 0;
+        Clock::duration ttl_ = Clock::duration::zero();
+        size_t inflight_num_ = 0;
+        uint64_t generation_ = 0;
+    };
+
+    ThreadPool &pool_;
+    std::shared_ptr<State> state_;
+};
+
+template<typename Key, typename Result, typename Hash>
+SingleFlight<Key, Result, Hash>::SingleFlight(ThreadPool &pool, size_t cache_capacity, Clock::duration ttl) :
+    pool_(pool), state_(std::make_shared<State>())
+{
+    state_->cache_capacity_ = cache_capacity;
+    state_->ttl_ = ttl;
+}
+
+template<typename Key, typename Result, typename Hash>
+template<typename Fn, typename... Args>
+std::shared_future<Result> SingleFlight<Key, Result, Hash>::add_task_once(const Key &key, TaskPriority priority,
+                                                                          Fn &&f, Args &&...args)
+{
+    std::unique_lock lock(state_->mtx_);
+    auto it = state_->entries_.find(key);
+    if (it != state_->entries_.end())
+    {
+        Entry &entry = it->second;
+        if (!entry.done_)
+            return entry.future_;
+        if (state_->ttl_ == Clock::duration::zero() || Clock::now() < entry.expire_at_)
+        {
+            state_->lru_.splice(state_->lru_.begin(), state_->lru_, entry.lru_);
+            return entry.future_;
+        }
+        state_->erase(it);
+    }
+
+    auto flight = std::make_shared<Flight>(state_, key, ++state_->generation_);
+    std::shared_future<Result> future = flight->promise_.get_future().share();
+    Entry &entry = state_->entries_[key];
+    entry.future_ = future;
+    entry.generation_ = flight->generation_;
+    ++state_->inflight_num_;
+    lock.unlock();
+
+    try
+    {
+        pool_.add_task(priority,
+                       [flight, callable = std::bind(std::forward<Fn>(f), std::forward<Args>(args)...)]() mutable
+                       {
+                           flight->run(callable);
+                       });
+    }
+    catch (...)
+    {
+        // Callers that already joined this flight see the submission error; the flight's destructor
+        // removes the entry.
+        flight->promise_.set_exception(std::current_exception());
+        throw;
+    }
+    return future;
+}
+
+template<typename Key, typename Result, typename Hash>
+template<typename Fn, typename... Args>
+std::shared_future<Result> SingleFlight<Key, Result, Hash>::add_task_once(const Key &key, Fn &&f, Args &&...args)
+{
+    return add_task_once(key, TaskPriority::Normal, std::forward<Fn>(f), std::forward<Args>(args)...);
+}
+
+template<typename Key, typename Result, typename Hash>
+void SingleFlight<Key, Result, Hash>::forget(const Key &key)
+{
+    std::lock_guard lock(state_->mtx_);
+    auto it = state_->entries_.find(key);
+    if (it != state_->entries_.end() && it->second.done_)
+        state_->erase(it);
+}
+
+template<typename Key, typename Result, typename Hash>
+size_t SingleFlight<Key, Result, Hash>::get_inflight_num() const
+{
+    std::lock_guard lock(state_->mtx_);
+    return state_->inflight_num_;
+}
+
+template<typename Key, typename Result, typename Hash>
+size_t SingleFlight<Key, Result, Hash>::get_cached_num() const
+{
+    std::lock_guard lock(state_->mtx_);
+    return state_->lru_.size();
+}
+
+template<typename Key, typename Result, typename Hash>
+SingleFlight<Key, Result, Hash>::Flight::Flight(std::shared_ptr<State> state, Key key, uint64_t generation) :
+    state_(std::move(state)), key_(std::move(key)), generation_(generation)
+{
+}
+
+template<typename Key, typename Result, typename Hash>
+SingleFlight<Key, Result, Hash>::Flight::~Flight()
+{
+    if (!finished_)
+        state_->complete(key_, generation_, false);
+}
+
+template<typename Key, typename Result, typename Hash>
+template<typename Callable>
+void SingleFlight<Key, Result, Hash>::Flight::run(Callable &callable)
+{
+    bool succeeded = true;
+    try
+    {
+        if constexpr (std::is_void_v<Result>)
+        {
+            callable();
+            promise_.set_value();
+        }
+        else
+        {
+            promise_.set_value(callable());
+        }
+    }
+    catch (...)
+    {
+        succeeded = false;
+        promise_.set_exception(std::current_exception());
+    }
+    finished_ = true;
+    state_->complete(key_, generation_, succeeded);
+}
+
+template<typename Key, typename Result, typename Hash>
+void SingleFlight<Key, Result, Hash>::State::complete(const Key &key, uint64_t generation, bool succeeded)
+{
+    std::lock_guard lock(mtx_);
+    --inflight_num_;
+    auto it = entries_.find(key);
+    if (it == entries_.end() || it->second.generation_ != generation)
+        return;
+
+    // Failures are never cached, so the next caller retries.
+    if (!succeeded || cache_capacity_ == 0)
+    {
+        entries_.erase(it);
+        return;
+    }
+
+    Entry &entry = it->second;
+    entry.done_ = true;
+    entry.expire_at_ = Clock::now() + ttl_;
+    entry.lru_ = lru_.insert(lru_.begin(), key);
+    while (lru_.size() > cache_capacity_)
+    {
+        erase(entries_.find(lru_.back()));
+    }
+}
+
+template<typename Key, typename Result, typename Hash>
+void SingleFlight<Key, Result, Hash>::State::erase(typename std::unordered_map<Key, Entry, Hash>::iterator it)
+{
+    if (it->second.done_)
+        lru_.erase(it->second.lru_);
+    entries_.erase(it);
+}
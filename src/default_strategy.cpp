@@ -2,7 +2,7 @@
 
 #include <numeric>
 
-void DefaultStrategy::dispatch_task(std::vector<std::shared_ptr<Worker>> workers,const Task &task) 
+void DefaultStrategy::dispatch_task(const std::vector<std::shared_ptr<Worker>>& workers,Task &&task) 
 {
     if (!workers.empty())
     {
@@ -15,7 +15,7 @@ void DefaultStrategy::dispatch_task(std::vector<std::shared_ptr<Worker>> workers
                                    });
         if (it == workers.end())
             return;
-        it->get()->add_task(task);
+        it->get()->add_task(std::move(task));
     }
 }
 
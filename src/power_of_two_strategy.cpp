@@ -0,0 +1,35 @@
+#include "power_of_two_strategy.h"
+
+#include <functional>
+#include <thread>
+
+void PowerOfTwoStrategy::dispatch_task(const std::vector<std::shared_ptr<Worker>>& workers,Task &&task)
+{
+    if (workers.empty())
+        return;
+    if (workers.size() == 1)
+    {
+        workers.front()->add_task(std::move(task));
+        return;
+    }
+
+    size_t first = next_index(workers.size());
+    size_t second = next_index(workers.size() - 1);
+    if (second >= first)
+        ++second;
+
+    const auto &a = workers[first];
+    const auto &b = workers[second];
+    (a->pending_task_size() <= b->pending_task_size() ? a : b)->add_task(std::move(task));
+}
+
+size_t PowerOfTwoStrategy::next_index(size_t bound)
+{
+    // xorshift64* with per-thread state, so one strategy instance can be shared by several pools.
+    static thread_local uint64_t seed =
+            0x9E3779B97F4A7C15ULL ^ static_cast<uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    seed ^= seed >> 12;
+    seed ^= seed << 25;
+    seed ^= seed >> 27;
+    return static_cast<size_t>((seed * 0x2545F4914F6CDD1DULL) % bound);
+}
@@ -0,0 +1,44 @@
+#include "scheduling_class.h"
+
+#include <algorithm>
+
+SchedulingClass::SchedulingClass(std::string name, uint32_t weight, TaskPriority priority) :
+    name_(std::move(name)), weight_(std::max<uint32_t>(weight, 1)), priority_(priority)
+{
+}
+
+const std::string &SchedulingClass::get_name() const
+{
+    return name_;
+}
+
+uint32_t SchedulingClass::get_weight() const
+{
+    return weight_.load(std::memory_order_relaxed);
+}
+
+void SchedulingClass::set_weight(uint32_t weight)
+{
+    weight_.store(std::max<uint32_t>(weight, 1), std::memory_order_relaxed);
+}
+
+TaskPriority SchedulingClass::get_priority() const
+{
+    return priority_;
+}
+
+std::chrono::nanoseconds SchedulingClass::get_consumed_time() const
+{
+    return std::chrono::nanoseconds(consumed_ns_.load(std::memory_order_relaxed));
+}
+
+size_t SchedulingClass::get_completed_task_num() const
+{
+    return completed_task_num_.load(std::memory_order_relaxed);
+}
+
+void SchedulingClass::charge(std::chrono::nanoseconds elapsed)
+{
+    consumed_ns_.fetch_add(elapsed.count(), std::memory_order_relaxed);
+    completed_task_num_.fetch_add(1, std::memory_order_relaxed);
+}
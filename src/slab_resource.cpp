@@ -0,0 +1,202 @@
+#include "slab_resource.h"
+
+#include <algorithm>
+
+namespace
+{
+constexpr size_t size_classes[] = {32, 64, 128, 256, SlabResource::max_block_size};
+
+constexpr size_t size_class_num = sizeof(size_classes) / sizeof(size_classes[0]);
+
+size_t size_class_of(size_t bytes)
+{
+    return std::lower_bound(std::begin(size_classes), std::end(size_classes), bytes) - std::begin(size_classes);
+}
+
+std::atomic<uint64_t> next_resource_id{0};
+}
+
+struct alignas(alignof(std::max_align_t)) SlabResource::Header
+{
+    Cache *owner;
+    size_t size_class;
+    // Only meaningful while the block is free; overlays the first bytes handed to the user.
+    Header *&next() { return *reinterpret_cast<Header **>(this + 1); }
+};
+
+struct SlabResource::Cache
+{
+    Header *free_[size_class_num] = {};
+    std::atomic<Header *> remote_{nullptr};
+    std::atomic<bool> owned_{true};
+    std::vector<void *> slabs_;
+    char *cursor_ = nullptr;
+    char *end_ = nullptr;
+
+    void push(Header *block)
+    {
+        block->next() = free_[block->size_class];
+        free_[block->size_class] = block;
+    }
+
+    void push_remote(Header *block)
+    {
+        Header *head = remote_.load(std::memory_order_relaxed);
+        do
+        {
+            block->next() = head;
+        } while (!remote_.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void reclaim_remote()
+    {
+        Header *block = remote_.exchange(nullptr, std::memory_order_acquire);
+        while (block != nullptr)
+        {
+            Header *next = block->next();
+            push(block);
+            block = next;
+        }
+    }
+};
+
+// The caches the current thread owns, keyed by resource id so a destroyed resource is never looked up
+// through a recycled address. On thread exit the caches are released for adoption by new threads.
+struct SlabResource::ThreadCaches
+{
+    struct Entry
+    {
+        uint64_t id;
+        Cache *cache;
+        std::weak_ptr<Cache> handle;
+    };
+
+    std::vector<Entry> entries_;
+
+    ~ThreadCaches()
+    {
+        for (auto &entry: entries_)
+        {
+            if (auto cache = entry.handle.lock())
+                cache->owned_.store(false, std::memory_order_release);
+        }
+    }
+};
+
+SlabResource::SlabResource(std::pmr::memory_resource *upstream) :
+    upstream_(upstream), id_(next_resource_id.fetch_add(1, std::memory_order_relaxed))
+{
+}
+
+SlabResource::~SlabResource()
+{
+    std::lock_guard lock(mtx_);
+    for (auto &cache: caches_)
+    {
+        for (void *slab: cache->slabs_)
+        {
+            upstream_->deallocate(slab, slab_size, alignof(std::max_align_t));
+        }
+        cache->slabs_.clear();
+    }
+}
+
+std::pmr::memory_resource *SlabResource::upstream() const
+{
+    return upstream_;
+}
+
+SlabResource *SlabResource::global()
+{
+    // Never destroyed: futures and tasks may release their blocks during static destruction.
+    static auto *resource = new SlabResource();
+    return resource;
+}
+
+SlabResource::Cache *SlabResource::local_cache(bool create)
+{
+    static thread_local ThreadCaches thread_caches;
+    for (auto &entry: thread_caches.entries_)
+    {
+        if (entry.id == id_)
+            return entry.cache;
+    }
+    if (!create)
+        return nullptr;
+
+    std::shared_ptr<Cache> cache;
+    {
+        std::lock_guard lock(mtx_);
+        for (auto &orphan: caches_)
+        {
+            bool owned = false;
+            if (orphan->owned_.compare_exchange_strong(owned, true, std::memory_order_acquire))
+            {
+                cache = orphan;
+                break;
+            }
+        }
+        if (cache == nullptr)
+        {
+            cache = std::make_shared<Cache>();
+            caches_.push_back(cache);
+        }
+    }
+    thread_caches.entries_.push_back({id_, cache.get(), cache});
+    return cache.get();
+}
+
+SlabResource::Header *SlabResource::carve(Cache *cache, size_t size_class)
+{
+    size_t stride = sizeof(Header) + size_classes[size_class];
+    if (static_cast<size_t>(cache->end_ - cache->cursor_) < stride)
+    {
+        void *slab = upstream_->allocate(slab_size, alignof(std::max_align_t));
+        cache->slabs_.push_back(slab);
+        cache->cursor_ = static_cast<char *>(slab);
+        cache->end_ = cache->cursor_ + slab_size;
+    }
+    auto *block = reinterpret_cast<Header *>(cache->cursor_);
+    cache->cursor_ += stride;
+    block->owner = cache;
+    block->size_class = size_class;
+    return block;
+}
+
+void *SlabResource::do_allocate(size_t bytes, size_t alignment)
+{
+    if (bytes > max_block_size || alignment > alignof(std::max_align_t))
+        return upstream_->allocate(bytes, alignment);
+
+    size_t size_class = size_class_of(bytes);
+    Cache *cache = local_cache(true);
+    if (cache->free_[size_class] == nullptr)
+        cache->reclaim_remote();
+
+    Header *block = cache->free_[size_class];
+    if (block != nullptr)
+        cache->free_[size_class] = block->next();
+    else
+        block = carve(cache, size_class);
+    return block + 1;
+}
+
+void SlabResource::do_deallocate(void *p, size_t bytes, size_t alignment)
+{
+    if (bytes > max_block_size || alignment > alignof(std::max_align_t))
+    {
+        upstream_->deallocate(p, bytes, alignment);
+        return;
+    }
+
+    Header *block = static_cast<Header *>(p) - 1;
+    if (block->owner == local_cache(false))
+        block->owner->push(block);
+    else
+        block->owner->push_remote(block);
+}
+
+bool SlabResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
@@ -1,11 +1,18 @@
 #include "task.h"
 
-Task::Task(std::function<void()> task, TaskPriority priority):task_(std::move(task)),priority_(priority)
+Task::Task(std::function<void()> task, TaskPriority priority, std::shared_ptr<SchedulingClass> scheduling_class):
+    task_(std::move(task)),priority_(priority),scheduling_class_(std::move(scheduling_class))
 {
+#ifdef THREAD_POOL_ENABLE_TRACE
+    trace_id_ = Tracer::is_enabled() ? Tracer::next_id() : 0;
+#endif
 }
 
-Task::Task(const Task & other)  : task_(other.task_), priority_(other.priority_)
+Task::Task(const Task & other)  : task_(other.task_), priority_(other.priority_), scheduling_class_(other.scheduling_class_)
 {
+#ifdef THREAD_POOL_ENABLE_TRACE
+    trace_id_ = other.trace_id_;
+#endif
 }
 
 Task & Task::operator=(const Task & other)
@@ -14,12 +21,20 @@ Task & Task::operator=(const Task & other)
     {
         task_ = other.task_;
         priority_ = other.priority_;
+        scheduling_class_ = other.scheduling_class_;
+#ifdef THREAD_POOL_ENABLE_TRACE
+        trace_id_ = other.trace_id_;
+#endif
     }
     return *this;
 }
 
-Task::Task(Task && task) noexcept : task_(std::move(task.task_)), priority_(task.priority_)
+Task::Task(Task && task) noexcept : task_(std::move(task.task_)), priority_(task.priority_),
+    scheduling_class_(std::move(task.scheduling_class_))
 {
+#ifdef THREAD_POOL_ENABLE_TRACE
+    trace_id_ = task.trace_id_;
+#endif
 }
 
 Task & Task::operator=(Task && other) noexcept
@@ -28,6 +43,10 @@ Task & Task::operator=(Task && other) noexcept
     {
         task_ = std::move(other.task_);
         priority_ = other.priority_;
+        scheduling_class_ = std::move(other.scheduling_class_);
+#ifdef THREAD_POOL_ENABLE_TRACE
+        trace_id_ = other.trace_id_;
+#endif
     }
     return *this;
 }
@@ -63,7 +82,14 @@ void Task::operator()() const noexcept
     }
 }
 
+const std::shared_ptr<SchedulingClass>& Task::scheduling_class() const
+{
+    return scheduling_class_;
+}
 
-
-
-
+#ifdef THREAD_POOL_ENABLE_TRACE
+uint64_t Task::trace_id() const
+{
+    return trace_id_;
+}
+#endif
@@ -0,0 +1,205 @@
+#include "trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+// One slot of a ring. seq_ holds (position + 1) << 8 | event once the slot is complete and 0 while the
+// owner rewrites it, so a dump running concurrently can detect and skip slots overwritten under it.
+struct Record
+{
+    std::atomic<uint64_t> seq_{0};
+    std::atomic<uint64_t> ts_ns_{0};
+    std::atomic<uint64_t> id_{0};
+};
+
+// Written only by the thread currently holding it. Rings are never freed: when a thread exits its ring
+// is marked free and handed to the next thread that records, so memory is bounded by the peak number
+// of concurrently recording threads rather than by every thread ever created.
+struct Ring
+{
+    explicit Ring(uint32_t tid) : records_(std::make_unique<Record[]>(Tracer::ring_capacity)), tid_(tid) {}
+
+    std::unique_ptr<Record[]> records_;
+    std::atomic<uint64_t> head_{0};
+    // Positions below tail_ were cleared; only clear() writes it, so it never races with the owner.
+    std::atomic<uint64_t> tail_{0};
+    bool in_use_ = true;
+    const uint32_t tid_;
+};
+
+struct Registry
+{
+    std::mutex mtx_;
+    std::vector<std::unique_ptr<Ring>> rings_;
+    std::atomic<uint64_t> next_id_{1};
+};
+
+Registry &registry()
+{
+    static Registry registry;
+    return registry;
+}
+
+// Leases a ring to the current thread and returns it to the registry when the thread exits.
+struct RingLease
+{
+    RingLease()
+    {
+        auto &reg = registry();
+        std::lock_guard lock(reg.mtx_);
+        for (auto &free_ring: reg.rings_)
+        {
+            if (!free_ring->in_use_)
+            {
+                free_ring->in_use_ = true;
+                ring_ = free_ring.get();
+                return;
+            }
+        }
+        ring_ = reg.rings_.emplace_back(std::make_unique<Ring>(static_cast<uint32_t>(reg.rings_.size()) + 1)).get();
+    }
+
+    ~RingLease()
+    {
+        auto &reg = registry();
+        std::lock_guard lock(reg.mtx_);
+        ring_->in_use_ = false;
+    }
+
+    Ring *ring_ = nullptr;
+};
+
+Ring &local_ring()
+{
+    static thread_local RingLease lease;
+    return *lease.ring_;
+}
+
+uint64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+}
+
+void write_event(std::ofstream &out, bool &first, const char *name, const char *phase, uint32_t tid, double ts_us,
+                 uint64_t id, bool async)
+{
+    out << (first ? "\n" : ",\n");
+    first = false;
+    out << R"({"name":")" << name << R"(","cat":"thread_pool","ph":")" << phase << R"(","pid":1,"tid":)" << tid
+        << R"(,"ts":)" << ts_us;
+    if (async)
+        out << R"(,"id":)" << id;
+    else if (phase[0] == 'i')
+        out << R"(,"s":"t")";
+    out << R"(,"args":{"id":)" << id << "}}";
+}
+}
+
+void Tracer::enable()
+{
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::disable()
+{
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+uint64_t Tracer::next_id()
+{
+    return registry().next_id_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Tracer::record(TraceEvent event, uint64_t id)
+{
+    Ring &ring = local_ring();
+    uint64_t head = ring.head_.load(std::memory_order_relaxed);
+    Record &record = ring.records_[head % ring_capacity];
+    record.seq_.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    record.ts_ns_.store(now_ns(), std::memory_order_relaxed);
+    record.id_.store(id, std::memory_order_relaxed);
+    record.seq_.store((head + 1) << 8 | static_cast<uint8_t>(event), std::memory_order_release);
+    ring.head_.store(head + 1, std::memory_order_release);
+}
+
+void Tracer::clear()
+{
+    auto &reg = registry();
+    std::lock_guard lock(reg.mtx_);
+    for (auto &ring: reg.rings_)
+    {
+        ring->tail_.store(ring->head_.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+bool Tracer::dump_chrome_trace(const std::string &path)
+{
+    std::ofstream out(path);
+    if (!out)
+        return false;
+
+    auto &reg = registry();
+    std::lock_guard lock(reg.mtx_);
+
+    out << R"({"displayTimeUnit":"ns","traceEvents":[)";
+    out.precision(3);
+    out << std::fixed;
+    bool first = true;
+    for (auto &ring: reg.rings_)
+    {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << ring->tid_ << R"(,"args":{"name":"thread )"
+            << ring->tid_ << R"("}})";
+
+        uint64_t head = ring->head_.load(std::memory_order_acquire);
+        uint64_t begin = std::max(ring->tail_.load(std::memory_order_relaxed),
+                                  head > ring_capacity ? head - ring_capacity : 0);
+        for (uint64_t i = begin; i < head; ++i)
+        {
+            // Seqlock read: skip the slot if the owner has started overwriting it since position i.
+            const Record &record = ring->records_[i % ring_capacity];
+            uint64_t seq = record.seq_.load(std::memory_order_acquire);
+            uint64_t ts_ns = record.ts_ns_.load(std::memory_order_relaxed);
+            uint64_t id = record.id_.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq >> 8 != i + 1 || record.seq_.load(std::memory_order_relaxed) != seq)
+                continue;
+
+            double ts_us = static_cast<double>(ts_ns) / 1000.0;
+            switch (static_cast<TraceEvent>(seq & 0xff))
+            {
+                case TraceEvent::Submit:
+                    write_event(out, first, "queued", "b", ring->tid_, ts_us, id, true);
+                    break;
+                case TraceEvent::Dispatch:
+                    write_event(out, first, "dispatch", "n", ring->tid_, ts_us, id, true);
+                    break;
+                case TraceEvent::Start:
+                    write_event(out, first, "queued", "e", ring->tid_, ts_us, id, true);
+                    write_event(out, first, "task", "B", ring->tid_, ts_us, id, false);
+                    break;
+                case TraceEvent::End:
+                    write_event(out, first, "task", "E", ring->tid_, ts_us, id, false);
+                    break;
+                case TraceEvent::WorkerSpawn:
+                    write_event(out, first, "worker_spawn", "i", ring->tid_, ts_us, id, false);
+                    break;
+                case TraceEvent::WorkerStop:
+                    write_event(out, first, "worker_stop", "i", ring->tid_, ts_us, id, false);
+                    break;
+            }
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
@@ -8,9 +8,10 @@ Worker::Worker()
 
 Worker::Worker(const Worker &other)
 {
-    std::shared_lock lock(other.mtx_);
+    std::lock_guard lock(other.mtx_);
     status_ = other.status_;
     task_queue_ = other.task_queue_;
+    submitted_num_.store(task_queue_.size(), std::memory_order_relaxed);
 
     if (other.thread_ptr_ && thread_ptr_ == nullptr)
     {
@@ -22,11 +23,12 @@ Worker &Worker::operator=(const Worker &other)
 {
     if (this != &other)
     {
-        std::unique_lock lock_m(mtx_);
-        std::shared_lock lock_o(other.mtx_);
+        std::scoped_lock lock(mtx_, other.mtx_);
 
         status_ = other.status_;
         task_queue_ = other.task_queue_;
+        completed_num_.store(0, std::memory_order_relaxed);
+        submitted_num_.store(task_queue_.size(), std::memory_order_relaxed);
 
         if (other.thread_ptr_ && thread_ptr_ == nullptr)
         {
@@ -38,9 +40,11 @@ Worker &Worker::operator=(const Worker &other)
 
 Worker::Worker(Worker&& other) noexcept
 {
-    std::unique_lock lock_m(mtx_);
+    std::lock_guard lock(other.mtx_);
     status_ = other.status_;
     task_queue_ = std::move(other.task_queue_);
+    submitted_num_.store(task_queue_.size(), std::memory_order_relaxed);
+    other.completed_num_.store(other.submitted_num_.load(std::memory_order_relaxed), std::memory_order_relaxed);
     thread_ptr_ = std::move(other.thread_ptr_);
 }
 
@@ -48,9 +52,12 @@ Worker &Worker::operator=(Worker&& other) noexcept
 {
     if (this != &other)
     {
-        std::unique_lock lock_m(mtx_);
+        std::scoped_lock lock(mtx_, other.mtx_);
         status_ = other.status_;
         task_queue_ = std::move(other.task_queue_);
+        completed_num_.store(0, std::memory_order_relaxed);
+        submitted_num_.store(task_queue_.size(), std::memory_order_relaxed);
+        other.completed_num_.store(other.submitted_num_.load(std::memory_order_relaxed), std::memory_order_relaxed);
         if (other.thread_ptr_ && thread_ptr_ == nullptr)
         {
             thread_ptr_ = std::move(other.thread_ptr_);
@@ -90,6 +97,7 @@ void Worker::stop()
         if (status_ == WorkerStatus::Finish)
             return;
         status_ = WorkerStatus::Finish;
+        completed_num_.fetch_add(task_queue_.size(), std::memory_order_relaxed);
         task_queue_.clear();
     }
     notify();
@@ -101,48 +109,93 @@ void Worker::stop()
 
 bool Worker::is_busy() const
 {
-    std::shared_lock lock(mtx_);
-    return !task_queue_.empty();
+    return pending_task_size() != 0;
 }
 
 size_t Worker::pending_task_size() const
 {
-    std::shared_lock lock(mtx_);
-    return task_queue_.size();
+    // Completed first: submitted only grows, so it can never be read smaller than completed.
+    size_t completed = completed_num_.load(std::memory_order_acquire);
+    return submitted_num_.load(std::memory_order_acquire) - completed;
+}
+
+void Worker::set_task_source(std::function<bool(Task &)> source)
+{
+    std::unique_lock lock(mtx_);
+    task_source_ = std::move(source);
+}
+
+bool Worker::has_task_source() const
+{
+    std::lock_guard lock(mtx_);
+    return task_source_ != nullptr;
+}
+
+bool Worker::pull_task()
+{
+    Task task;
+    if (!task_source_ || !task_source_(task))
+        return false;
+    THREAD_POOL_TRACE(TraceEvent::Dispatch, task.trace_id());
+    submitted_num_.fetch_add(1, std::memory_order_release);
+    task_queue_.push(std::move(task));
+    return true;
 }
 
 void Worker::notify()
 {
-    cond_.notify_all();
+    cond_.notify_one();
 }
 
 void Worker::add_task(const Task &task)
 {
-    task_queue_.push(task);
+    add_task(Task(task));
+}
+
+void Worker::add_task(Task &&task)
+{
+    {
+        // Pushing under mtx_ keeps the task from slipping in between run()'s check and its wait.
+        std::lock_guard lock(mtx_);
+        submitted_num_.fetch_add(1, std::memory_order_release);
+        task_queue_.push(std::move(task));
+    }
     notify();
 }
 
 void Worker::run()
 {
+    THREAD_POOL_TRACE(TraceEvent::WorkerSpawn, 0);
     while (true)
     {
         Task task;
         {
             std::unique_lock lock(mtx_);
             cond_.wait(lock, [this]
-                       { return (status_ == WorkerStatus::Busy && !task_queue_.empty()) || status_ == WorkerStatus::Finish; });
+                       {
+                           return (status_ == WorkerStatus::Busy && (!task_queue_.empty() || pull_task())) ||
+                                  status_ == WorkerStatus::Finish;
+                       });
             if (status_ == WorkerStatus::Finish)
             {
+                THREAD_POOL_TRACE(TraceEvent::WorkerStop, 0);
                 return;
             }
-            task = task_queue_.top();
+            task = task_queue_.pop();
         }
-        task();
+        THREAD_POOL_TRACE(TraceEvent::Start, task.trace_id());
+        if (const auto &scheduling_class = task.scheduling_class())
         {
-            std::unique_lock lock(mtx_);
-            if (!task_queue_.empty())
-                task_queue_.pop();
+            auto begin = std::chrono::steady_clock::now();
+            task();
+            scheduling_class->charge(std::chrono::steady_clock::now() - begin);
+        }
+        else
+        {
+            task();
         }
+        THREAD_POOL_TRACE(TraceEvent::End, task.trace_id());
+        completed_num_.fetch_add(1, std::memory_order_release);
     }
 }
 
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "thread_pool.hpp"
+
+#include <deque>
+
+// A Strand serialises the tasks posted to it: they run one at a time, in the order they were added,
+// on whichever worker picks up the strand. Different strands sharing a pool run in parallel.
+class Strand
+{
+public:
+    explicit Strand(ThreadPool &pool, TaskPriority priority = TaskPriority::Normal, size_t batch_size = 64);
+
+    Strand(const Strand &) = delete;
+
+    Strand &operator=(const Strand &) = delete;
+
+    ~Strand() = default;
+
+    template<typename Fn, typename... Args>
+    auto add_task(Fn &&f, Args &&...args)
+            -> std::future<decltype(f(std::forward<Args>(args)...))>;
+
+    size_t get_task_num() const;
+
+private:
+    struct State
+    {
+        // Drops every queued task, breaking their promises, and marks the strand idle.
+        void release();
+
+        mutable std::mutex mtx_;
+        std::deque<std::function<void()>> tasks_;
+        bool scheduled_ = false;
+    };
+
+    // One drain submitted to the pool. If the pool drops or rejects it without running (stop() clears
+    // the queues), its destructor releases the strand so queued tasks fail instead of hanging.
+    struct Drain
+    {
+        Drain(ThreadPool &pool, std::shared_ptr<State> state, TaskPriority priority, size_t batch_size);
+
+        Drain(Drain &&) noexcept = default;
+
+        ~Drain();
+
+        void operator()();
+
+        ThreadPool *pool_;
+        std::shared_ptr<State> state_;
+        TaskPriority priority_;
+        size_t batch_size_;
+    };
+
+    ThreadPool &pool_;
+    std::shared_ptr<State> state_;
+    TaskPriority priority_ = TaskPriority::Normal;
+    size_t batch_size_ = 64;
+};
+
+inline Strand::Strand(ThreadPool &pool, TaskPriority priority, size_t batch_size) :
+    pool_(pool), state_(std::make_shared<State>()), priority_(priority), batch_size_(batch_size == 0 ? 1 : batch_size)
+{
+}
+
+inline size_t Strand::get_task_num() const
+{
+    std::lock_guard lock(state_->mtx_);
+    return state_->tasks_.size();
+}
+
+template<typename Fn, typename... Args>
+auto Strand::add_task(Fn &&f, Args &&...args)
+        -> std::future<decltype(f(std::forward<Args>(args)...))>
+{
+    using return_type = decltype(f(std::forward<Args>(args)...));
+    auto task = std::make_shared<std::packaged_task<return_type()>>(
+            std::bind(std::forward<Fn>(f), std::forward<Args>(args)...));
+    auto future = task->get_future();
+
+    if (pool_.get_status() == ThreadPool::Status::Stop)
+    {
+        throw std::runtime_error("Strand::add_task() failed, The ThreadPool has been Stopped.");
+    }
+
+    bool schedule = false;
+    {
+        std::lock_guard lock(state_->mtx_);
+        state_->tasks_.emplace_back([task]() { (*task)(); });
+        schedule = !std::exchange(state_->scheduled_, true);
+    }
+    // The first task of an idle strand schedules a drain on the pool; later tasks ride along with it.
+    // The pool is called without the strand lock, since a dropped drain takes it from inside the pool.
+    if (schedule)
+        pool_.add_task(priority_, Drain(pool_, state_, priority_, batch_size_));
+    return future;
+}
+
+inline void Strand::State::release()
+{
+    std::deque<std::function<void()>> dropped;
+    std::lock_guard lock(mtx_);
+    dropped.swap(tasks_);
+    scheduled_ = false;
+}
+
+inline Strand::Drain::Drain(ThreadPool &pool, std::shared_ptr<State> state, TaskPriority priority,
+                            size_t batch_size) :
+    pool_(&pool), state_(std::move(state)), priority_(priority), batch_size_(batch_size)
+{
+}
+
+inline Strand::Drain::~Drain()
+{
+    if (state_ != nullptr)
+        state_->release();
+}
+
+inline void Strand::Drain::operator()()
+{
+    for (size_t i = 0; i < batch_size_; ++i)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(state_->mtx_);
+            if (state_->tasks_.empty())
+            {
+                // An idle strand gives up its state, so the destructor does not release it.
+                state_->scheduled_ = false;
+                lock.unlock();
+                state_.reset();
+                return;
+            }
+            task = std::move(state_->tasks_.front());
+            state_->tasks_.pop_front();
+        }
+        task();
+    }
+
+    // Yield the worker after a full batch so other strands and plain tasks are not starved.
+    {
+        std::unique_lock lock(state_->mtx_);
+        if (state_->tasks_.empty())
+        {
+            state_->scheduled_ = false;
+            lock.unlock();
+            state_.reset();
+            return;
+        }
+    }
+    // If the pool rejects the resubmission, the moved drain's destructor releases the strand.
+    ThreadPool &pool = *pool_;
+    TaskPriority priority = priority_;
+    pool.add_task(priority, std::move(*this));
+}
@@ -0,0 +1,46 @@
+#include "thread_pool.hpp"
+
+int main()
+{
+    ThreadPool pool(1, 1, 1);
+    pool.start();
+
+    auto tenant_a = pool.add_scheduling_class("tenant_a", 3);
+    auto tenant_b = pool.add_scheduling_class("tenant_b", 1);
+
+    std::mutex mtx;
+    std::vector<std::string> order;
+    std::vector<std::future<void>> futures;
+
+    pool.pause();
+    for (int i = 0; i < 400; ++i)
+    {
+        for (const auto &tenant: {tenant_a, tenant_b})
+        {
+            futures.emplace_back(pool.add_task(tenant, [&, tenant]()
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(20));
+                std::lock_guard lock(mtx);
+                order.push_back(tenant->get_name());
+            }));
+        }
+    }
+    pool.resume();
+
+    for (auto &future: futures)
+    {
+        future.get();
+    }
+
+    size_t tenant_a_num = std::count(order.begin(), order.begin() + 400, "tenant_a");
+    std::cout << "tenant_a tasks in the first 400: " << tenant_a_num << std::endl;
+    for (const auto &tenant: pool.get_scheduling_classes())
+    {
+        std::cout << tenant->get_name() << " weight: " << tenant->get_weight()
+                  << " completed: " << tenant->get_completed_task_num() << " consumed: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(tenant->get_consumed_time()).count()
+                  << "us" << std::endl;
+    }
+
+    return tenant_a_num == 300 ? 0 : 1;
+}
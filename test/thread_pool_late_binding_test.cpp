@@ -0,0 +1,53 @@
+#include "thread_pool.hpp"
+
+int main()
+{
+    ThreadPool pool(2, 2, 2);
+    pool.set_prefetch_depth(1);
+    pool.start();
+
+    std::promise<void> gate;
+    auto gate_future = gate.get_future().share();
+    std::mutex mtx;
+    std::vector<TaskPriority> order;
+    std::vector<std::future<void>> futures;
+
+    std::atomic<int> blocked = 0;
+
+    // Occupy both workers, then queue a backlog of Low tasks before one Highest task.
+    for (int i = 0; i < 2; ++i)
+    {
+        futures.emplace_back(pool.add_task([gate_future, &blocked]()
+        {
+            ++blocked;
+            gate_future.wait();
+        }));
+    }
+    while (blocked != 2)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    for (int i = 0; i < 20; ++i)
+    {
+        futures.emplace_back(pool.add_task(TaskPriority::Low, [&]()
+        {
+            std::lock_guard lock(mtx);
+            order.push_back(TaskPriority::Low);
+        }));
+    }
+    futures.emplace_back(pool.add_task(TaskPriority::Highest, [&]()
+    {
+        std::lock_guard lock(mtx);
+        order.push_back(TaskPriority::Highest);
+    }));
+    gate.set_value();
+    for (auto &future: futures)
+    {
+        future.get();
+    }
+
+    size_t highest_pos = std::find(order.begin(), order.end(), TaskPriority::Highest) - order.begin();
+    std::cout << "The Highest task started at position: " << highest_pos << std::endl;
+    return highest_pos < 2 ? 0 : 1;
+}
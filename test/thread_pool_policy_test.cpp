@@ -0,0 +1,97 @@
+#include "basic_thread_pool.hpp"
+
+#include <iostream>
+#include <string>
+
+template<typename Pool>
+long long sum_tasks(Pool &pool)
+{
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 10000; ++i)
+    {
+        futures.emplace_back(pool.add_task([](int param) { return param * 2; }, i));
+    }
+
+    long long sum = 0;
+    for (auto &future: futures)
+    {
+        sum += future.get();
+    }
+    return sum;
+}
+
+int main()
+{
+    FixedThreadPool fixed_pool(4);
+    fixed_pool.start();
+    long long fixed_sum = sum_tasks(fixed_pool);
+    std::cout << "FixedThreadPool result sum is: " << fixed_sum << std::endl;
+
+    // Captures too large for the inline buffer fall back to the heap.
+    std::string prefix(32, 'a');
+    std::string suffix(32, 'b');
+    auto concat = fixed_pool.add_task([prefix, suffix]() { return prefix + suffix; });
+    bool large_ok = concat.get() == prefix + suffix;
+    std::cout << "FixedThreadPool large capture ok: " << std::boolalpha << large_ok << std::endl;
+
+    SpinningThreadPool spinning_pool(2);
+    spinning_pool.start();
+    long long spinning_sum = sum_tasks(spinning_pool);
+    std::cout << "SpinningThreadPool result sum is: " << spinning_sum << std::endl;
+
+    // A single worker blocked on the gate lets the following tasks queue up and run in priority order.
+    BasicThreadPool<PriorityQueuePolicy, BlockingIdle, FixedScaling, InplaceTask<64>> priority_pool(1);
+    priority_pool.start();
+
+    std::promise<void> gate;
+    auto gate_future = gate.get_future().share();
+    std::vector<TaskPriority> order;
+    std::vector<std::future<void>> futures;
+
+    futures.emplace_back(priority_pool.add_task([gate_future]() { gate_future.wait(); }));
+    for (auto priority: {TaskPriority::Lowest, TaskPriority::Normal, TaskPriority::Highest, TaskPriority::Low,
+                         TaskPriority::High})
+    {
+        futures.emplace_back(priority_pool.add_task(priority, [&order, priority]() { order.push_back(priority); }));
+    }
+    gate.set_value();
+    for (auto &future: futures)
+    {
+        future.get();
+    }
+
+    bool ordered = order == std::vector<TaskPriority>{TaskPriority::Highest, TaskPriority::High, TaskPriority::Normal,
+                                                      TaskPriority::Low, TaskPriority::Lowest};
+    std::cout << "Priority tasks ordered: " << std::boolalpha << ordered << std::endl;
+
+    // A backlog behind a blocked worker makes the dynamic pool grow.
+    DynamicPriorityThreadPool dynamic_pool(1, 1, 4);
+    dynamic_pool.start();
+
+    std::promise<void> dynamic_gate;
+    auto dynamic_gate_future = dynamic_gate.get_future().share();
+    std::vector<std::future<void>> dynamic_futures;
+    for (int i = 0; i < 4; ++i)
+    {
+        dynamic_futures.emplace_back(dynamic_pool.add_task([dynamic_gate_future]() { dynamic_gate_future.wait(); }));
+    }
+    size_t dynamic_thread_num = dynamic_pool.get_thread_num();
+    std::cout << "DynamicPriorityThreadPool worker num is: " << dynamic_thread_num << std::endl;
+    dynamic_gate.set_value();
+    for (auto &future: dynamic_futures)
+    {
+        future.get();
+    }
+
+    fixed_pool.stop();
+    try
+    {
+        fixed_pool.add_task([]() {});
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << e.what() << std::endl;
+    }
+
+    return fixed_sum == 99990000 && large_ok && spinning_sum == 99990000 && ordered && dynamic_thread_num > 1 ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+#include "thread_pool.hpp"
+#include "power_of_two_strategy.h"
+
+// Written against the original by-value dispatch_task() signature, which the pool still calls.
+class LegacyStrategy : public ThreadPoolStrategy
+{
+public:
+    void dispatch_task(std::vector<std::shared_ptr<Worker>> workers, const Task &task) override
+    {
+        ++dispatched_;
+        workers.front()->add_task(task);
+    }
+
+    void adjust_worker(size_t, size_t, size_t, std::vector<std::shared_ptr<Worker>> &) override {}
+
+    std::atomic<size_t> dispatched_ = 0;
+};
+
+long long sum_tasks(ThreadPool &pool)
+{
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 10000; ++i)
+    {
+        futures.emplace_back(pool.add_task([](int param) { return param * 2; }, i));
+    }
+
+    long long sum = 0;
+    for (auto &future: futures)
+    {
+        sum += future.get();
+    }
+    return sum;
+}
+
+int main()
+{
+    // One strategy instance shared by two pools dispatching concurrently.
+    auto strategy = std::make_shared<PowerOfTwoStrategy>();
+    ThreadPool pool(4, 4, 4, strategy);
+    ThreadPool other_pool(2, 2, 2, strategy);
+    pool.start();
+    other_pool.start();
+
+    auto other_future = std::async(std::launch::async, [&other_pool]() { return sum_tasks(other_pool); });
+    long long sum = sum_tasks(pool);
+    long long other_sum = other_future.get();
+
+    std::cout << "The Task Result sum is: " << sum << std::endl;
+    std::cout << "The other pool Task Result sum is: " << other_sum << std::endl;
+    std::cout << "The worker num is: " << pool.get_thread_num() << std::endl;
+
+    auto legacy = std::make_shared<LegacyStrategy>();
+    ThreadPool legacy_pool(1, 1, 1, legacy);
+    legacy_pool.start();
+    long long legacy_sum = sum_tasks(legacy_pool);
+    std::cout << "The legacy strategy dispatched: " << legacy->dispatched_ << std::endl;
+
+    return sum == 99990000 && other_sum == 99990000 && legacy_sum == 99990000 && legacy->dispatched_ == 10000
+                   ? 0
+                   : 1;
+}
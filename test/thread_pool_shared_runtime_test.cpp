@@ -0,0 +1,165 @@
+#include "shared_runtime.hpp"
+
+int main()
+{
+    SharedRuntime runtime(4);
+
+    auto serial = runtime.create_executor("serial", 1);
+    auto parallel = runtime.create_executor("parallel", 2, 2, TaskPriority::High);
+
+    std::atomic<size_t> serial_running = 0;
+    std::atomic<size_t> parallel_running = 0;
+    std::atomic<size_t> serial_peak = 0;
+    std::atomic<size_t> parallel_peak = 0;
+
+    auto track = [](std::atomic<size_t> &running, std::atomic<size_t> &peak)
+    {
+        size_t now = running.fetch_add(1) + 1;
+        size_t old = peak.load();
+        while (now > old && !peak.compare_exchange_weak(old, now))
+        {
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        running.fetch_sub(1);
+    };
+
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 500; ++i)
+    {
+        futures.emplace_back(serial->add_task(track, std::ref(serial_running), std::ref(serial_peak)));
+        futures.emplace_back(parallel->add_task(track, std::ref(parallel_running), std::ref(parallel_peak)));
+    }
+    for (auto &future: futures)
+    {
+        future.get();
+    }
+
+    std::cout << "The runtime thread num is: " << runtime.get_thread_num() << std::endl;
+    for (const auto &executor: runtime.get_executors())
+    {
+        std::cout << executor->get_name() << " max concurrency: " << executor->get_max_concurrency()
+                  << " completed: " << executor->get_completed_task_num() << std::endl;
+    }
+    std::cout << "serial peak concurrency: " << serial_peak << std::endl;
+    std::cout << "parallel peak concurrency: " << parallel_peak << std::endl;
+
+    // Names are unique among live executors; a released executor frees its name.
+    bool duplicate_rejected = false;
+    try
+    {
+        runtime.create_executor("serial", 1);
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cout << e.what() << std::endl;
+        duplicate_rejected = true;
+    }
+    runtime.create_executor("temporary", 1);
+    auto temporary = runtime.create_executor("temporary", 1);
+    size_t executor_num = runtime.get_executors().size();
+    std::cout << "live executor num: " << executor_num << std::endl;
+
+    // A drain dropped by the runtime's shutdown fails the backlog it was scheduled for. The holder keeps
+    // the only runtime thread busy until the dropped task has failed.
+    std::future<void> dropped;
+    {
+        auto stopping_runtime = std::make_unique<SharedRuntime>(1);
+        auto holder = stopping_runtime->create_executor("holder", 1);
+        auto waiter = stopping_runtime->create_executor("waiter", 1);
+
+        std::promise<void> started;
+        std::promise<void> gate;
+        auto blocked = holder->add_task([&started, gate_future = gate.get_future()]()
+        {
+            started.set_value();
+            gate_future.wait();
+        });
+        started.get_future().wait();
+
+        dropped = waiter->add_task([]() {});
+        std::thread opener([&dropped, &gate]()
+        {
+            dropped.wait();
+            gate.set_value();
+        });
+        stopping_runtime.reset();
+        opener.join();
+        blocked.get();
+    }
+
+    // A higher-priority executor is served before a lower one, even when the lower one queued first.
+    std::string order;
+    {
+        SharedRuntime single_runtime(1);
+        auto gate_executor = single_runtime.create_executor("gate", 1);
+        auto low = single_runtime.create_executor("low", 1, 1, TaskPriority::Lowest);
+        auto high = single_runtime.create_executor("high", 1, 1, TaskPriority::Highest);
+
+        std::promise<void> started;
+        std::promise<void> gate;
+        auto gated = gate_executor->add_task([&started, gate_future = gate.get_future()]()
+        {
+            started.set_value();
+            gate_future.wait();
+        });
+        started.get_future().wait();
+
+        std::vector<std::future<void>> ordered_futures;
+        for (auto *executor: {&low, &high})
+        {
+            char name = *executor == low ? 'L' : 'H';
+            for (int i = 0; i < 5; ++i)
+            {
+                ordered_futures.emplace_back((*executor)->add_task([&order, name]() { order.push_back(name); }));
+            }
+        }
+        gate.set_value();
+        gated.get();
+        for (auto &future: ordered_futures)
+        {
+            future.get();
+        }
+    }
+    std::cout << "Executor priority order: " << order << std::endl;
+
+    // Destroying a runtime whose executor still has more than a batch queued must not hang.
+    std::vector<std::future<void>> backlog;
+    {
+        SharedRuntime backlog_runtime(2);
+        auto executor = backlog_runtime.create_executor("backlog", 1, 1, TaskPriority::Normal, 1);
+        for (int i = 0; i < 10; ++i)
+        {
+            backlog.emplace_back(executor->add_task([]() { std::this_thread::sleep_for(std::chrono::milliseconds(20)); }));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    }
+    size_t backlog_done = 0;
+    for (auto &future: backlog)
+    {
+        try
+        {
+            future.get();
+        }
+        catch (const std::future_error &)
+        {
+        }
+        ++backlog_done;
+    }
+    std::cout << "Backlog futures settled after shutdown: " << backlog_done << std::endl;
+
+    bool broken = false;
+    try
+    {
+        dropped.get();
+    }
+    catch (const std::future_error &e)
+    {
+        broken = e.code() == std::future_errc::broken_promise;
+    }
+    std::cout << "Dropped executor task broken: " << std::boolalpha << broken << std::endl;
+
+    return serial_peak == 1 && parallel_peak <= 2 && duplicate_rejected && executor_num == 3 && broken &&
+                           order == "HHHHHLLLLL" && backlog_done == backlog.size()
+                   ? 0
+                   : 1;
+}
@@ -0,0 +1,54 @@
+#include "single_flight.hpp"
+
+int main()
+{
+    ThreadPool pool(2, 2, 2);
+    pool.start();
+
+    std::atomic<int> exec_num = 0;
+    auto compute = [&exec_num]()
+    {
+        ++exec_num;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return 42;
+    };
+
+    // Concurrent submissions for one key while it is in flight share a single execution.
+    SingleFlight<std::string, int> flights(pool);
+    std::vector<std::shared_future<int>> futures;
+    for (int i = 0; i < 100; ++i)
+    {
+        futures.emplace_back(flights.add_task_once("key", compute));
+    }
+    bool all_equal = true;
+    for (auto &future: futures)
+    {
+        all_equal = all_equal && future.get() == 42;
+    }
+    std::cout << "In-flight executions for 100 submissions: " << exec_num << std::endl;
+    bool deduplicated = exec_num == 1;
+
+    // With a result cache, completed keys are served until their TTL expires.
+    SingleFlight<std::string, int> cached_flights(pool, 16, std::chrono::milliseconds(100));
+    exec_num = 0;
+    cached_flights.add_task_once("key", compute).get();
+    cached_flights.add_task_once("key", compute).get();
+    int cached_exec_num = exec_num;
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    cached_flights.add_task_once("key", compute).get();
+    std::cout << "Executions before and after TTL: " << cached_exec_num << " " << exec_num << std::endl;
+
+    // Failures are not cached.
+    auto failed = cached_flights.add_task_once("error", []() -> int { throw std::runtime_error("task failed"); });
+    try
+    {
+        failed.get();
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "The Task Exception is: " << e.what() << std::endl;
+    }
+    std::cout << "Cached keys: " << cached_flights.get_cached_num() << std::endl;
+
+    return all_equal && deduplicated && cached_exec_num == 1 && exec_num == 2 ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+#include "thread_pool.hpp"
+
+int main()
+{
+    SlabResource resource;
+
+    // A block released on another thread returns to the cache of the thread that allocated it.
+    void *block = resource.allocate(48);
+    std::thread([&]() { resource.deallocate(block, 48); }).join();
+    void *reused = resource.allocate(48);
+    std::cout << "Remote freed block reused: " << std::boolalpha << (block == reused) << std::endl;
+    resource.deallocate(reused, 48);
+
+    ThreadPool pool(2, 2, 2, std::make_shared<DefaultStrategy>(), &resource);
+    pool.start();
+
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 10000; ++i)
+    {
+        futures.emplace_back(pool.add_task([](int param) { return param * 2; }, i));
+    }
+
+    long long sum = 0;
+    for (auto &future: futures)
+    {
+        sum += future.get();
+    }
+    futures.clear();
+    std::cout << "The Task Result sum is: " << sum << std::endl;
+
+    auto failed = pool.add_task([]() -> int { throw std::runtime_error("task failed"); });
+    try
+    {
+        failed.get();
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "The Task Exception is: " << e.what() << std::endl;
+    }
+
+    pool.stop();
+    return block == reused && sum == 99990000 ? 0 : 1;
+}
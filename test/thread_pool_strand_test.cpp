@@ -0,0 +1,119 @@
+#include "strand.hpp"
+
+int main()
+{
+    ThreadPool pool(4, 4, 4);
+    pool.start();
+
+    const int strand_num = 8;
+    const int task_num = 1000;
+
+    std::vector<std::unique_ptr<Strand>> strands;
+    std::vector<std::vector<int>> results(strand_num);
+    std::vector<std::atomic<int>> running(strand_num);
+    std::atomic<bool> overlapped = false;
+
+    for (int i = 0; i < strand_num; ++i)
+    {
+        strands.emplace_back(std::make_unique<Strand>(pool));
+    }
+
+    std::vector<std::future<void>> futures;
+    for (int j = 0; j < task_num; ++j)
+    {
+        for (int i = 0; i < strand_num; ++i)
+        {
+            futures.emplace_back(strands[i]->add_task([&, i, j]()
+            {
+                if (running[i].fetch_add(1) != 0)
+                    overlapped = true;
+                results[i].push_back(j);
+                running[i].fetch_sub(1);
+            }));
+        }
+    }
+
+    for (auto &future: futures)
+    {
+        future.get();
+    }
+
+    bool ordered = true;
+    for (int i = 0; i < strand_num; ++i)
+    {
+        for (int j = 0; j < task_num; ++j)
+        {
+            if (results[i].size() != task_num || results[i][j] != j)
+                ordered = false;
+        }
+    }
+
+    std::cout << "Strand tasks ordered: " << std::boolalpha << ordered << std::endl;
+    std::cout << "Strand tasks overlapped: " << std::boolalpha << overlapped.load() << std::endl;
+
+    // A drain dropped by stop() fails the queued tasks, and the strand rejects new ones.
+    ThreadPool stopped_pool(1, 1, 1);
+    stopped_pool.start();
+    stopped_pool.pause();
+    Strand stopped_strand(stopped_pool);
+    auto dropped = stopped_strand.add_task([]() {});
+    stopped_pool.stop();
+
+    bool broken = false;
+    try
+    {
+        dropped.get();
+    }
+    catch (const std::future_error &e)
+    {
+        broken = e.code() == std::future_errc::broken_promise;
+    }
+
+    bool rejected = false;
+    try
+    {
+        stopped_strand.add_task([]() {});
+    }
+    catch (const std::runtime_error &)
+    {
+        rejected = true;
+    }
+
+    std::cout << "Dropped strand task broken: " << std::boolalpha << broken << std::endl;
+    std::cout << "Strand rejected after stop: " << std::boolalpha << rejected << std::endl;
+
+    // Stopping while a drain runs with more than a batch left: its resubmission is rejected and the
+    // rest of the backlog fails instead of hanging stop().
+    ThreadPool running_pool(2, 2, 2);
+    running_pool.start();
+    Strand running_strand(running_pool, TaskPriority::Normal, 2);
+    std::vector<std::future<void>> running_futures;
+    for (int i = 0; i < 10; ++i)
+    {
+        running_futures.emplace_back(
+                running_strand.add_task([]() { std::this_thread::sleep_for(std::chrono::milliseconds(20)); }));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    running_pool.stop();
+
+    size_t completed_num = 0;
+    size_t broken_num = 0;
+    for (auto &future: running_futures)
+    {
+        try
+        {
+            future.get();
+            ++completed_num;
+        }
+        catch (const std::future_error &)
+        {
+            ++broken_num;
+        }
+    }
+    std::cout << "Strand tasks completed before stop: " << completed_num << ", failed: " << broken_num << std::endl;
+    bool stopped_running = completed_num + broken_num == running_futures.size() && broken_num > 0;
+
+    return ordered && !overlapped && broken && rejected && stopped_strand.get_task_num() == 0 && stopped_running
+                   ? 0
+                   : 1;
+}
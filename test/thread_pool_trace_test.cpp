@@ -0,0 +1,71 @@
+#include "thread_pool.hpp"
+
+#include <fstream>
+#include <sstream>
+
+int main()
+{
+    ThreadPool pool(2, 2, 2);
+    Tracer::enable();
+    pool.start();
+
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 100; ++i)
+    {
+        futures.emplace_back(pool.add_task(i % 2 ? TaskPriority::High : TaskPriority::Low,
+                                           []() { std::this_thread::sleep_for(std::chrono::microseconds(10)); }));
+    }
+    for (auto &future: futures)
+    {
+        future.get();
+    }
+
+    pool.stop();
+    Tracer::disable();
+
+    const std::string path = "thread_pool_trace.json";
+    if (!Tracer::dump_chrome_trace(path))
+    {
+        std::cout << "Dump trace failed" << std::endl;
+        return 1;
+    }
+
+    auto count = [&path](const std::string &pattern)
+    {
+        std::ifstream in(path);
+        std::stringstream content;
+        content << in.rdbuf();
+        std::string trace = content.str();
+        size_t num = 0;
+        for (size_t pos = trace.find(pattern); pos != std::string::npos; pos = trace.find(pattern, pos + 1))
+        {
+            ++num;
+        }
+        return num;
+    };
+
+    size_t task_num = count(R"("ph":"B")");
+    size_t thread_num = count("thread_name");
+    std::cout << "Traced task num is: " << task_num << std::endl;
+
+    // Threads that exit hand their ring to the next one, and dumps may run while a ring wraps.
+    for (int i = 0; i < 16; ++i)
+    {
+        std::thread([]() { Tracer::record(TraceEvent::WorkerSpawn, 0); }).join();
+    }
+    std::thread writer([]()
+                       {
+                           for (size_t i = 0; i < 4 * Tracer::ring_capacity; ++i)
+                           {
+                               Tracer::record(TraceEvent::WorkerStop, i);
+                           }
+                       });
+    bool dumped = Tracer::dump_chrome_trace(path);
+    writer.join();
+    dumped = dumped && Tracer::dump_chrome_trace(path);
+    size_t reused_thread_num = count("thread_name");
+    std::cout << "Traced thread num is: " << thread_num << ", after thread churn: " << reused_thread_num << std::endl;
+
+    std::cout << "The trace is written to: " << path << std::endl;
+    return task_num == futures.size() && dumped && reused_thread_num == thread_num ? 0 : 1;
+}
@@ -0,0 +1,44 @@
+#include "thread_pool.hpp"
+
+int main()
+{
+    ThreadPool pool(2, 2, 2);
+    pool.start();
+
+    std::atomic<int> done = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        pool.add_task([&done]() { ++done; });
+    }
+    pool.wait_idle();
+    std::cout << "Tasks done after wait_idle: " << done << std::endl;
+    bool idle_ok = done == 1000;
+
+    // Phase one runs freely, phase two is held back; the barrier only waits for phase one.
+    std::promise<void> gate;
+    auto gate_future = gate.get_future().share();
+    std::atomic<int> phase_one = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        pool.add_task([&phase_one]()
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            ++phase_one;
+        });
+    }
+    uint64_t epoch = pool.barrier();
+    pool.add_task([gate_future]() { gate_future.wait(); });
+
+    pool.wait_barrier(epoch);
+    std::cout << "Phase one tasks done at the barrier: " << phase_one << std::endl;
+    bool barrier_ok = phase_one == 100;
+
+    bool idle_while_blocked = pool.wait_idle_for(std::chrono::milliseconds(20));
+    std::cout << "Idle while phase two is blocked: " << std::boolalpha << idle_while_blocked << std::endl;
+
+    gate.set_value();
+    bool idle_after_release = pool.wait_idle_for(std::chrono::seconds(5));
+    std::cout << "Idle after phase two is released: " << std::boolalpha << idle_after_release << std::endl;
+
+    return idle_ok && barrier_ok && !idle_while_blocked && idle_after_release ? 0 : 1;
+}
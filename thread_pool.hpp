@@ -1,10 +1,15 @@
 #pragma once
 
 #include "default_strategy.h"
+#include "slab_resource.h"
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <future>
 #include <iostream>
 #include <numeric>
+#include <utility>
 
 class ThreadPool
 {
@@ -20,7 +25,8 @@ public:
 
     explicit ThreadPool(size_t min_thread_num = 1, size_t thread_num = std::thread::hardware_concurrency() - 1,
                         size_t max_thread_num = std::thread::hardware_concurrency() - 1,
-                        const std::shared_ptr<ThreadPoolStrategy> &strategy = std::make_shared<DefaultStrategy>());
+                        const std::shared_ptr<ThreadPoolStrategy> &strategy = std::make_shared<DefaultStrategy>(),
+                        std::pmr::memory_resource *resource = SlabResource::global());
 
     ~ThreadPool();
 
@@ -40,17 +46,87 @@ public:
     auto add_task(Fn &&f, Args &&...args)
             -> std::future<decltype(f(std::forward<Args>(args)...))>;
 
+    template<typename Fn, typename... Args>
+    auto add_task(const std::shared_ptr<SchedulingClass> &scheduling_class, TaskPriority priority, Fn &&f,
+                  Args &&...args) -> std::future<decltype(f(std::forward<Args>(args)...))>;
+
+    template<typename Fn, typename... Args>
+    auto add_task(const std::shared_ptr<SchedulingClass> &scheduling_class, Fn &&f, Args &&...args)
+            -> std::future<decltype(f(std::forward<Args>(args)...))>;
+
+    std::shared_ptr<SchedulingClass> add_scheduling_class(const std::string &name, uint32_t weight);
+
+    std::vector<std::shared_ptr<SchedulingClass>> get_scheduling_classes() const;
+
+    // Late binding: with depth > 0 each worker holds at most depth tasks, counting the one it runs, and
+    // pulls the next one from the pool queue when it runs dry. Depth 1 makes the next task started
+    // anywhere in the pool the highest-priority one available. 0 (the default) dispatches eagerly.
+    void set_prefetch_depth(size_t depth);
+
+    size_t get_prefetch_depth() const;
+
+    // Blocks until every task submitted so far has finished or been dropped by stop().
+    void wait_idle() const;
+
+    template<typename Rep, typename Period>
+    bool wait_idle_for(const std::chrono::duration<Rep, Period> &timeout) const;
+
+    // Closes the current submission epoch and returns its id; wait_barrier() then waits only for the
+    // tasks submitted up to this call, regardless of what is submitted afterwards.
+    uint64_t barrier();
+
+    void wait_barrier(uint64_t epoch) const;
+
+    template<typename Rep, typename Period>
+    bool wait_barrier_for(uint64_t epoch, const std::chrono::duration<Rep, Period> &timeout) const;
+
     size_t get_thread_num() const;
 
     Status get_status() const;
 
     size_t get_task_num() const;
 
+    std::pmr::memory_resource *get_memory_resource() const;
+
     static std::string status_to_string(const Status &status);
 
 private:
+    struct Epoch
+    {
+        explicit Epoch(uint64_t id) : id_(id) {}
 
-    void dispatch_task(const Task &task);
+        const uint64_t id_;
+        std::atomic<size_t> pending_num_{0};
+        bool closed_ = false;
+    };
+
+    // The callable and its result state of one submission, allocated together from the pool's resource.
+    template<typename R, typename Callable>
+    struct TaskState
+    {
+        TaskState(const std::pmr::polymorphic_allocator<std::byte> &alloc, Callable &&callable);
+
+        ~TaskState();
+
+        void run();
+
+        std::promise<R> promise_;
+        Callable callable_;
+        ThreadPool *pool_ = nullptr;
+        Epoch *epoch_ = nullptr;
+    };
+
+    void finish_task(Epoch *epoch) const;
+
+    bool is_barrier_reached(uint64_t epoch) const;
+
+    void retire_epochs() const;
+
+    void dispatch_task(Task &&task);
+
+    void prefetch_tasks(size_t depth);
+
+    bool has_prefetch_capacity(size_t depth) const;
 
     void add_worker();
 
@@ -58,11 +134,27 @@ private:
 
     Status status_ = Status::Stop;
     mutable std::shared_mutex mtx_;
-    PriorityQueue<Task> task_queue_;
+    // Also popped by workers pulling without mtx_, so it sits apart from the pool lock.
+    alignas(cache_line_size) FairQueue<Task> task_queue_;
+    alignas(cache_line_size) std::atomic<size_t> prefetch_depth_{0};
+    alignas(cache_line_size) std::condition_variable_any cond_;
+    // Workers stay behind shared_ptr rather than in one contiguous array: strategies create, stop and erase
+    // them through adjust_worker(), and each worker thread holds its this pointer, so they cannot move.
+    // Every hot field inside Worker already has a cache line of its own, and dispatch takes the vector
+    // by const reference, so no reference count is touched per task.
     std::vector<Worker_ptr> workers_;
-    std::condition_variable_any cond_;
+    std::vector<std::shared_ptr<SchedulingClass>> scheduling_classes_;
     std::unique_ptr<std::thread> thread_;
     std::shared_ptr<ThreadPoolStrategy> strategy_;
+    std::pmr::memory_resource *resource_;
+
+    // Submitted but not yet finished, across the whole pool and per epoch. Every epoch that may still
+    // hold tasks stays in epochs_; epoch_ is the open one new submissions join, guarded by mtx_.
+    alignas(cache_line_size) mutable std::atomic<size_t> inflight_num_{0};
+    alignas(cache_line_size) mutable std::mutex idle_mtx_;
+    mutable std::condition_variable idle_cond_;
+    mutable std::deque<std::unique_ptr<Epoch>> epochs_;
+    Epoch *epoch_ = nullptr;
 
     size_t min_thread_num_ = 1;
     size_t thread_num_ = std::thread::hardware_concurrency() - 1;
@@ -70,10 +162,12 @@ private:
 };
 
 inline ThreadPool::ThreadPool(size_t min_thread_num, size_t thread_num, size_t max_thread_num,
-                              const std::shared_ptr<ThreadPoolStrategy> &strategy) :
-    strategy_(strategy), min_thread_num_(min_thread_num), thread_num_(thread_num), max_thread_num_(max_thread_num)
+                              const std::shared_ptr<ThreadPoolStrategy> &strategy,
+                              std::pmr::memory_resource *resource) :
+    strategy_(strategy), resource_(resource), min_thread_num_(min_thread_num), thread_num_(thread_num), max_thread_num_(max_thread_num)
 {
     workers_.reserve(max_thread_num_);
+    epoch_ = epochs_.emplace_back(std::make_unique<Epoch>(0)).get();
 }
 
 inline ThreadPool::~ThreadPool() { stop(); }
@@ -95,19 +189,23 @@ inline void ThreadPool::start()
 
 inline void ThreadPool::stop()
 {
+    std::vector<Worker_ptr> workers;
     {
         std::unique_lock lock(mtx_);
         if (status_ == Status::Stop)
             return;
         status_ = Status::Stop;
-        for (auto &worker: workers_)
-        {
-            worker->stop();
-        }
-        workers_.clear();
+        // Drop the undispatched tasks first, so they fail right away instead of after the running ones.
         task_queue_.clear();
+        workers.swap(workers_);
     }
     cond_.notify_all();
+    // Workers are joined without mtx_, so a running task that submits to the pool gets the Stopped
+    // error instead of waiting for the lock held by this join.
+    for (auto &worker: workers)
+    {
+        worker->stop();
+    }
     if (thread_ != nullptr && thread_->joinable())
         thread_->join();
 }
@@ -163,6 +261,112 @@ inline ThreadPool::Status ThreadPool::get_status() const
     return status_;
 }
 
+inline void ThreadPool::wait_idle() const
+{
+    std::unique_lock lock(idle_mtx_);
+    idle_cond_.wait(lock, [this]() { return inflight_num_.load(std::memory_order_acquire) == 0; });
+}
+
+template<typename Rep, typename Period>
+bool ThreadPool::wait_idle_for(const std::chrono::duration<Rep, Period> &timeout) const
+{
+    std::unique_lock lock(idle_mtx_);
+    return idle_cond_.wait_for(lock, timeout,
+                               [this]() { return inflight_num_.load(std::memory_order_acquire) == 0; });
+}
+
+inline uint64_t ThreadPool::barrier()
+{
+    std::unique_lock lock(mtx_);
+    std::lock_guard idle_lock(idle_mtx_);
+    // Retire here too, so callers that never wait on barriers do not grow epochs_ without bound.
+    retire_epochs();
+    uint64_t id = epoch_->id_;
+    epoch_->closed_ = true;
+    epoch_ = epochs_.emplace_back(std::make_unique<Epoch>(id + 1)).get();
+    return id;
+}
+
+inline void ThreadPool::wait_barrier(uint64_t epoch) const
+{
+    std::unique_lock lock(idle_mtx_);
+    idle_cond_.wait(lock, [this, epoch]() { return is_barrier_reached(epoch); });
+}
+
+template<typename Rep, typename Period>
+bool ThreadPool::wait_barrier_for(uint64_t epoch, const std::chrono::duration<Rep, Period> &timeout) const
+{
+    std::unique_lock lock(idle_mtx_);
+    return idle_cond_.wait_for(lock, timeout, [this, epoch]() { return is_barrier_reached(epoch); });
+}
+
+inline bool ThreadPool::is_barrier_reached(uint64_t epoch) const
+{
+    // Called with idle_mtx_ held. The open epoch is never retired, so the barrier is reached once the
+    // oldest remaining epoch is newer.
+    retire_epochs();
+    return epochs_.front()->id_ > epoch;
+}
+
+inline void ThreadPool::retire_epochs() const
+{
+    // Called with idle_mtx_ held; drained closed epochs are retired from the front.
+    while (epochs_.front()->closed_ && epochs_.front()->pending_num_.load(std::memory_order_acquire) == 0)
+    {
+        epochs_.pop_front();
+    }
+}
+
+inline void ThreadPool::finish_task(Epoch *epoch) const
+{
+    bool idle = inflight_num_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    bool drained = epoch->pending_num_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    if (idle || drained)
+    {
+        // Taking the lock orders this update before a waiter's predicate check or after its wait.
+        {
+            std::lock_guard lock(idle_mtx_);
+        }
+        idle_cond_.notify_all();
+    }
+}
+
+inline void ThreadPool::set_prefetch_depth(size_t depth)
+{
+    prefetch_depth_.store(depth, std::memory_order_relaxed);
+    cond_.notify_all();
+}
+
+inline size_t ThreadPool::get_prefetch_depth() const
+{
+    return prefetch_depth_.load(std::memory_order_relaxed);
+}
+
+inline std::shared_ptr<SchedulingClass> ThreadPool::add_scheduling_class(const std::string &name, uint32_t weight)
+{
+    std::unique_lock lock(mtx_);
+    for (auto &scheduling_class: scheduling_classes_)
+    {
+        if (scheduling_class->get_name() == name)
+        {
+            scheduling_class->set_weight(weight);
+            return scheduling_class;
+        }
+    }
+    return scheduling_classes_.emplace_back(std::make_shared<SchedulingClass>(name, weight));
+}
+
+inline std::vector<std::shared_ptr<SchedulingClass>> ThreadPool::get_scheduling_classes() const
+{
+    std::shared_lock lock(mtx_);
+    return scheduling_classes_;
+}
+
+inline std::pmr::memory_resource *ThreadPool::get_memory_resource() const
+{
+    return resource_;
+}
+
 inline std::string ThreadPool::status_to_string(const Status &status)
 {
     switch (status)
@@ -186,16 +390,70 @@ inline void ThreadPool::add_worker()
     }
 }
 
+template<typename R, typename Callable>
+ThreadPool::TaskState<R, Callable>::TaskState(const std::pmr::polymorphic_allocator<std::byte> &alloc,
+                                              Callable &&callable) :
+    promise_(std::allocator_arg, alloc), callable_(std::move(callable))
+{
+}
+
+template<typename R, typename Callable>
+ThreadPool::TaskState<R, Callable>::~TaskState()
+{
+    // A task dropped without running (stop() clears the queues) still counts as finished.
+    if (epoch_ != nullptr)
+        pool_->finish_task(epoch_);
+}
+
+template<typename R, typename Callable>
+void ThreadPool::TaskState<R, Callable>::run()
+{
+    try
+    {
+        if constexpr (std::is_void_v<R>)
+        {
+            callable_();
+            promise_.set_value();
+        }
+        else
+        {
+            promise_.set_value(callable_());
+        }
+    }
+    catch (...)
+    {
+        promise_.set_exception(std::current_exception());
+    }
+    if (epoch_ != nullptr)
+        pool_->finish_task(std::exchange(epoch_, nullptr));
+}
+
 template<typename Fn, typename... Args>
 auto ThreadPool::add_task(TaskPriority priority, Fn &&f, Args &&...args)
         -> std::future<decltype(f(std::forward<Args>(args)...))>
+{
+    return add_task(std::shared_ptr<SchedulingClass>(), priority, std::forward<Fn>(f), std::forward<Args>(args)...);
+}
+
+template<typename Fn, typename... Args>
+auto ThreadPool::add_task(const std::shared_ptr<SchedulingClass> &scheduling_class, Fn &&f, Args &&...args)
+        -> std::future<decltype(f(std::forward<Args>(args)...))>
+{
+    return add_task(scheduling_class, TaskPriority::Normal, std::forward<Fn>(f), std::forward<Args>(args)...);
+}
+
+template<typename Fn, typename... Args>
+auto ThreadPool::add_task(const std::shared_ptr<SchedulingClass> &scheduling_class, TaskPriority priority, Fn &&f,
+                          Args &&...args) -> std::future<decltype(f(std::forward<Args>(args)...))>
 {
     using return_type = decltype(f(std::forward<Args>(args)...));
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-            std::bind(std::forward<Fn>(f), std::forward<Args>(args)...));
-    Task priority_task([task]() { (*task)(); }, priority);
+    using callable_type = decltype(std::bind(std::forward<Fn>(f), std::forward<Args>(args)...));
+    std::pmr::polymorphic_allocator<std::byte> alloc(resource_);
+    auto task = std::allocate_shared<TaskState<return_type, callable_type>>(
+            alloc, alloc, std::bind(std::forward<Fn>(f), std::forward<Args>(args)...));
+    Task priority_task([task]() { task->run(); }, priority, scheduling_class);
 
-    auto future = task->get_future();
+    auto future = task->promise_.get_future();
 
     {
         std::unique_lock lock(mtx_);
@@ -203,7 +461,12 @@ auto ThreadPool::add_task(TaskPriority priority, Fn &&f, Args &&...args)
         {
             throw std::runtime_error("ThreadPool::add_task() failed, The ThreadPool has been Stopped.");
         }
-        task_queue_.push(priority_task);
+        THREAD_POOL_TRACE(TraceEvent::Submit, priority_task.trace_id());
+        task->pool_ = this;
+        task->epoch_ = epoch_;
+        inflight_num_.fetch_add(1, std::memory_order_relaxed);
+        epoch_->pending_num_.fetch_add(1, std::memory_order_relaxed);
+        task_queue_.push(std::move(priority_task));
     }
     cond_.notify_all();
     return future;
@@ -222,7 +485,14 @@ inline void ThreadPool::monitor()
     {
         std::unique_lock<std::shared_mutex> lock(mtx_);
         cond_.wait_for(lock, std::chrono::milliseconds(100), [&]()
-                       { return status_ == Status::Stop || (status_ == Status::Running && !task_queue_.empty()); });
+                       {
+                           if (status_ == Status::Stop)
+                               return true;
+                           if (status_ != Status::Running || task_queue_.empty())
+                               return false;
+                           size_t depth = prefetch_depth_.load(std::memory_order_relaxed);
+                           return depth == 0 || has_prefetch_capacity(depth);
+                       });
 
         if (status_ == Status::Stop)
             return;
@@ -233,16 +503,55 @@ inline void ThreadPool::monitor()
 
         if (task_queue_.empty())
             continue;
+
+        size_t depth = prefetch_depth_.load(std::memory_order_relaxed);
+        if (depth > 0)
+        {
+            prefetch_tasks(depth);
+            continue;
+        }
+
+        // Workers may pull from task_queue_ concurrently, so never pop without checking.
         size_t task_num = task_queue_.size();
-        for (size_t i = 0; i < task_num; ++i)
+        Task task;
+        for (size_t i = 0; i < task_num && task_queue_.try_pop(task); ++i)
+        {
+            dispatch_task(std::move(task));
+        }
+    }
+}
+
+inline void ThreadPool::prefetch_tasks(size_t depth)
+{
+    for (auto &worker: workers_)
+    {
+        if (!worker->has_task_source())
+        {
+            worker->set_task_source([this](Task &task)
+                                    {
+                                        return prefetch_depth_.load(std::memory_order_relaxed) > 0 &&
+                                               task_queue_.try_pop(task);
+                                    });
+        }
+
+        Task task;
+        while (worker->pending_task_size() < depth && task_queue_.try_pop(task))
         {
-            dispatch_task(task_queue_.pop());
+            THREAD_POOL_TRACE(TraceEvent::Dispatch, task.trace_id());
+            worker->add_task(std::move(task));
         }
     }
 }
 
-inline void ThreadPool::dispatch_task(const Task &task)
+inline bool ThreadPool::has_prefetch_capacity(size_t depth) const
+{
+    return std::any_of(workers_.begin(), workers_.end(),
+                       [depth](const auto &worker) { return worker->pending_task_size() < depth; });
+}
+
+inline void ThreadPool::dispatch_task(Task &&task)
 {
-    strategy_->dispatch_task(workers_, task);
+    THREAD_POOL_TRACE(TraceEvent::Dispatch, task.trace_id());
+    strategy_->dispatch_task(workers_, std::move(task));
 }
 